@@ -0,0 +1,39 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#ifndef HEAD_shaga_bench
+#define HEAD_shaga_bench
+
+/* Minimal benchmark harness. Every case is run once to warm up and then measured for given number of
+ * iterations. Reported are time per chunk, throughput and heap allocations per chunk. Allocations are
+ * counted by replaced global operator new, see main.cpp. */
+
+namespace shagabench {
+	struct Result {
+		/* Number of chunks and bytes processed in one iteration */
+		size_t chunks {0};
+		size_t bytes {0};
+	};
+
+	struct Case {
+		std::string name;
+		size_t iterations {0};
+		/* Called before measured batch, not included in the time (may prepare input consumed by run) */
+		std::function<void (const size_t iterations)> prepare;
+		/* One iteration */
+		std::function<Result (const size_t iteration)> run;
+	};
+
+	void add (Case &&c);
+
+	uint64_t get_allocations (void);
+
+	/* Defined in benchChunk.cpp */
+	void add_chunk_benchmarks (void);
+}
+
+#endif // HEAD_shaga_bench
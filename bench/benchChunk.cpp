@@ -0,0 +1,251 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#include "bench.h"
+
+using namespace shaga;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Workloads  //////////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static const constexpr size_t _bench_chunks {1000};
+
+static const std::array<Chunk::Priority, 4> _bench_priorities {
+	Chunk::Priority::pCRITICAL,
+	Chunk::Priority::pMANDATORY,
+	Chunk::Priority::pOPTIONAL,
+	Chunk::Priority::pDEBUG,
+};
+
+/* Small chunk without payload, e.g. keep-alive or acknowledgement */
+static void _bench_add_control (CHUNKLIST &lst, const size_t i)
+{
+	Chunk &chunk = lst.emplace_back (static_cast<HWID> (i & 0xFF), "PING", Chunk::Priority::pCRITICAL);
+	chunk.set_destination_hwid (static_cast<HWID> (0x100 + (i & 0xF)));
+}
+
+static void _bench_add_meta (CHUNKLIST &lst, const size_t i)
+{
+	Chunk &chunk = lst.emplace_back (static_cast<HWID> (i & 0xFF), "STAT", Chunk::Priority::pMANDATORY);
+	chunk.meta.add_uint8 ("VER", 3);
+	chunk.meta.add_uint16 ("SEQ", static_cast<uint16_t> (i));
+	chunk.meta.add_uint32 ("TIM", static_cast<uint32_t> (i * 1000));
+	chunk.meta.add_uint64 ("UID", static_cast<uint64_t> (i) << 32);
+	chunk.meta.add_int32 ("TMP", -static_cast<int32_t> (i % 40));
+	chunk.meta.add_value ("NAM", fmt::format ("sensor-{}"sv, i % 16));
+	chunk.meta.add_value ("LOC", "building A, floor 2"sv);
+	for (size_t j = 0; j < 4; ++j) {
+		chunk.meta.add_uint16 ("VAL", static_cast<uint16_t> (i + j));
+	}
+}
+
+static void _bench_add_payload (CHUNKLIST &lst, const size_t i)
+{
+	Chunk &chunk = lst.emplace_back (static_cast<HWID> (i & 0xFF), "DATA", Chunk::Priority::pOPTIONAL);
+	chunk.set_payload (std::string (4096, static_cast<char> ('a' + (i % 26))));
+}
+
+static void _bench_add_cbor (CHUNKLIST &lst, const size_t i)
+{
+	Chunk &chunk = lst.emplace_back (static_cast<HWID> (i & 0xFF), "JSON", Chunk::Priority::pMANDATORY);
+
+	CBOR::Writer w (128);
+	w.map (5);
+	w.entry ("id"sv, i);
+	w.entry ("temperature"sv, 21.5 + static_cast<double> (i % 10));
+	w.entry ("online"sv, (i % 2) == 0);
+	w.entry ("name"sv, "sensor"sv);
+	w.value ("values"sv).array (4);
+	for (size_t j = 0; j < 4; ++j) {
+		w.value (i * j);
+	}
+	chunk.set_cbor (w.release ());
+}
+
+static void _bench_add_mixed (CHUNKLIST &lst, const size_t i)
+{
+	switch (i % 8) {
+		case 0:
+			_bench_add_payload (lst, i);
+			break;
+		case 1:
+		case 2:
+			_bench_add_meta (lst, i);
+			break;
+		case 3:
+		case 4:
+			_bench_add_cbor (lst, i);
+			break;
+		default:
+			_bench_add_control (lst, i);
+			break;
+	}
+	lst.back ().set_prio (_bench_priorities[(i * 7) % _bench_priorities.size ()]);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Cases  //////////////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct BenchData {
+	CHUNKLIST chunks;
+	std::string bin;
+	std::vector<CHUNKLIST> copies;
+	std::string out;
+	ChunkTool tool;
+	ChunkPool pool {_bench_chunks};
+	ChunkPack pack;
+	std::string packed;
+};
+
+static void _bench_add_workload (const std::string_view name, void (*generator) (CHUNKLIST &, const size_t), const size_t iterations)
+{
+	auto data = std::make_shared<BenchData> ();
+	for (size_t i = 0; i < _bench_chunks; ++i) {
+		generator (data->chunks, i);
+	}
+	for (const auto &chunk : data->chunks) {
+		chunk.to_bin (data->bin);
+	}
+
+	const size_t cnt = data->chunks.size ();
+	const size_t bytes = data->bin.size ();
+
+	shagabench::add ({fmt::format ("{}/Chunk::to_bin"sv, name), iterations, nullptr, [data, cnt, bytes](const size_t) -> shagabench::Result {
+		data->out.resize (0);
+		for (const auto &chunk : data->chunks) {
+			chunk.to_bin (data->out);
+		}
+		return {cnt, bytes};
+	}});
+
+	shagabench::add ({fmt::format ("{}/Chunk(bin)"sv, name), iterations, nullptr, [data, cnt, bytes](const size_t) -> shagabench::Result {
+		size_t offset {0};
+		size_t types {0};
+		while (offset < data->bin.size ()) {
+			const Chunk chunk (data->bin, offset);
+			types += chunk.get_num_type ();
+		}
+		return {(types > 0) ? cnt : 0, bytes};
+	}});
+
+	shagabench::add ({fmt::format ("{}/ChunkView"sv, name), iterations, nullptr, [data, cnt, bytes](const size_t) -> shagabench::Result {
+		size_t offset {0};
+		size_t types {0};
+		while (offset < data->bin.size ()) {
+			const ChunkView view (data->bin, offset);
+			types += view.get_num_type ();
+		}
+		return {(types > 0) ? cnt : 0, bytes};
+	}});
+
+	shagabench::add ({fmt::format ("{}/ChunkPool::get(bin)"sv, name), iterations, nullptr, [data, cnt, bytes](const size_t) -> shagabench::Result {
+		size_t offset {0};
+		size_t types {0};
+		while (offset < data->bin.size ()) {
+			const auto chunk = data->pool.get (data->bin, offset);
+			types += chunk->get_num_type ();
+		}
+		return {(types > 0) ? cnt : 0, bytes};
+	}});
+
+	/* Batch serialization erases input, so copies are prepared outside of measured time */
+	shagabench::add ({fmt::format ("{}/ChunkTool::to_bin"sv, name), iterations,
+		[data](const size_t iters) -> void {
+			data->copies.assign (iters, data->chunks);
+		},
+		[data, cnt, bytes](const size_t iteration) -> shagabench::Result {
+			data->out.resize (0);
+			data->tool.to_bin (data->copies[iteration], data->out);
+			return {cnt, bytes};
+		}});
+
+	shagabench::add ({fmt::format ("{}/ChunkTool::from_bin"sv, name), iterations, nullptr, [data, cnt, bytes](const size_t) -> shagabench::Result {
+		CHUNKLIST lst;
+		size_t offset {0};
+		data->tool.from_bin (data->bin, offset, lst);
+		return {(lst.size () == cnt) ? cnt : 0, bytes};
+	}});
+
+	/* Bytes are reported for plain chunks, so throughput is comparable with ChunkTool */
+	CHUNKLIST tmp (data->chunks);
+	data->pack.to_bin (tmp, data->packed);
+
+	shagabench::add ({fmt::format ("{}/ChunkPack::to_bin"sv, name), iterations,
+		[data](const size_t iters) -> void {
+			data->copies.assign (iters, data->chunks);
+		},
+		[data, cnt, bytes](const size_t iteration) -> shagabench::Result {
+			data->out.resize (0);
+			data->pack.to_bin (data->copies[iteration], data->out);
+			return {cnt, bytes};
+		}});
+
+	shagabench::add ({fmt::format ("{}/ChunkPack::from_bin"sv, name), iterations, nullptr, [data, cnt, bytes](const size_t) -> shagabench::Result {
+		CHUNKLIST lst;
+		size_t offset {0};
+		data->pack.from_bin (data->packed, offset, lst);
+		return {(lst.size () == cnt) ? cnt : 0, bytes};
+	}});
+}
+
+static void _bench_add_meta_only (const size_t iterations)
+{
+	CHUNKLIST lst;
+	for (size_t i = 0; i < _bench_chunks; ++i) {
+		_bench_add_meta (lst, i);
+	}
+
+	auto metas = std::make_shared<std::vector<ChunkMeta>> ();
+	auto bin = std::make_shared<std::string> ();
+	for (const auto &chunk : lst) {
+		metas->push_back (chunk.meta);
+		chunk.meta.to_bin (*bin);
+	}
+
+	const size_t cnt = metas->size ();
+	const size_t bytes = bin->size ();
+	auto out = std::make_shared<std::string> ();
+
+	shagabench::add ({"meta/ChunkMeta::to_bin", iterations, nullptr, [metas, out, cnt, bytes](const size_t) -> shagabench::Result {
+		out->resize (0);
+		for (const auto &meta : *metas) {
+			meta.to_bin (*out);
+		}
+		return {cnt, bytes};
+	}});
+
+	/* Meta ends where the next chunk starts, so every serialized meta is decoded from its own view */
+	auto sizes = std::make_shared<std::vector<size_t>> ();
+	for (const auto &meta : *metas) {
+		sizes->push_back (meta.to_bin ().size ());
+	}
+
+	shagabench::add ({"meta/ChunkMeta::from_bin", iterations, nullptr, [bin, sizes, cnt, bytes](const size_t) -> shagabench::Result {
+		ChunkMeta meta;
+		size_t start {0};
+		size_t entries {0};
+		for (const size_t sze : *sizes) {
+			size_t offset {0};
+			meta.from_bin (std::string_view (*bin).substr (start, sze), offset);
+			entries += meta.size ();
+			start += sze;
+		}
+		return {(entries > 0) ? cnt : 0, bytes};
+	}});
+}
+
+void shagabench::add_chunk_benchmarks (void)
+{
+	_bench_add_workload ("control"sv, &_bench_add_control, 500);
+	_bench_add_workload ("meta"sv, &_bench_add_meta, 100);
+	_bench_add_workload ("payload4k"sv, &_bench_add_payload, 20);
+	_bench_add_workload ("cbor"sv, &_bench_add_cbor, 200);
+	_bench_add_workload ("mixed"sv, &_bench_add_mixed, 100);
+	_bench_add_meta_only (100);
+}
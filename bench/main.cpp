@@ -0,0 +1,140 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#include "bench.h"
+
+using namespace shaga;
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Allocation counting  ////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static std::atomic<uint64_t> _bench_allocations {0};
+
+void * operator new (std::size_t sze)
+{
+	_bench_allocations.fetch_add (1, std::memory_order_relaxed);
+	if (void *ptr = std::malloc ((0 == sze) ? 1 : sze); nullptr != ptr) {
+		return ptr;
+	}
+	throw std::bad_alloc ();
+}
+
+void * operator new[] (std::size_t sze)
+{
+	return ::operator new (sze);
+}
+
+void * operator new (std::size_t sze, const std::nothrow_t &) noexcept
+{
+	_bench_allocations.fetch_add (1, std::memory_order_relaxed);
+	return std::malloc ((0 == sze) ? 1 : sze);
+}
+
+void * operator new[] (std::size_t sze, const std::nothrow_t &tag) noexcept
+{
+	return ::operator new (sze, tag);
+}
+
+void operator delete (void *ptr) noexcept
+{
+	std::free (ptr);
+}
+
+void operator delete[] (void *ptr) noexcept
+{
+	std::free (ptr);
+}
+
+void operator delete (void *ptr, std::size_t) noexcept
+{
+	std::free (ptr);
+}
+
+void operator delete[] (void *ptr, std::size_t) noexcept
+{
+	std::free (ptr);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Harness  ////////////////////////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static std::vector<shagabench::Case> _bench_cases;
+
+void shagabench::add (Case &&c)
+{
+	_bench_cases.push_back (std::move (c));
+}
+
+uint64_t shagabench::get_allocations (void)
+{
+	return _bench_allocations.load (std::memory_order_relaxed);
+}
+
+static void _bench_run (const shagabench::Case &c, const size_t multiplier)
+{
+	const size_t iterations = std::max<size_t> (1, c.iterations * multiplier);
+
+	/* Warm up, so lazily allocated buffers are not counted */
+	if (c.prepare) {
+		c.prepare (1);
+	}
+	c.run (0);
+
+	if (c.prepare) {
+		c.prepare (iterations);
+	}
+
+	shagabench::Result total;
+	const uint64_t allocs_start = shagabench::get_allocations ();
+	const auto time_start = std::chrono::steady_clock::now ();
+
+	for (size_t i = 0; i < iterations; ++i) {
+		const shagabench::Result res = c.run (i);
+		total.chunks += res.chunks;
+		total.bytes += res.bytes;
+	}
+
+	const auto time_end = std::chrono::steady_clock::now ();
+	const uint64_t allocs = shagabench::get_allocations () - allocs_start;
+
+	const double ns = static_cast<double> (std::chrono::duration_cast<std::chrono::nanoseconds> (time_end - time_start).count ());
+	const double chunks = static_cast<double> (std::max<size_t> (1, total.chunks));
+
+	fmt::print ("{:<36} {:>12.1f} {:>12.1f} {:>12.2f}\n"sv,
+		c.name,
+		ns / chunks,
+		(ns > 0) ? ((static_cast<double> (total.bytes) * 1000.0) / ns) : 0.0,
+		static_cast<double> (allocs) / chunks);
+}
+
+int main (int argc, char **argv) try
+{
+	shaga::shaga_check ();
+
+	/* Usage: bench [filter] [multiplier of iterations] */
+	const std::string_view filter = (argc > 1) ? std::string_view (argv[1]) : ""sv;
+	const size_t multiplier = (argc > 2) ? STR::to_uint32 (argv[2]) : 1;
+
+	shagabench::add_chunk_benchmarks ();
+
+	fmt::print ("{:<36} {:>12} {:>12} {:>12}\n"sv, "Benchmark"sv, "ns/chunk"sv, "MB/s"sv, "allocs/chunk"sv);
+	for (const auto &c : _bench_cases) {
+		if (filter.empty () == true || c.name.find (filter) != std::string::npos) {
+			_bench_run (c, multiplier);
+		}
+	}
+
+	return 0;
+}
+catch (const std::exception &e) {
+	shaga::exit ("FATAL ERROR: {}", e.what ());
+}
+catch (...) {
+	shaga::exit ("FATAL ERROR: Unknown failure");
+}
@@ -181,6 +181,8 @@ namespace shaga::BIN
 
 	void from_size (const size_t sze, std::string &s);
 	std::string from_size (const size_t sze);
+	/* Write size to raw buffer, which must have at least 4 bytes available at pos */
+	void _from_size (const size_t sze, void *const buf, size_t &pos);
 
 	/* size utf8 */
 	size_t to_size_utf8 (const std::string_view s, size_t &offset);
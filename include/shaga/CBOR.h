@@ -0,0 +1,147 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#ifndef HEAD_shaga_CBOR
+#define HEAD_shaga_CBOR
+
+#include "common.h"
+
+/* Streaming CBOR (RFC 8949) writer and pull reader working directly on encoded bytes, without building
+ * nlohmann::json. Output is readable by nlohmann::json::from_cbor and everything produced by
+ * nlohmann::json::to_cbor can be read back.
+ *
+ * Writer appends items in order, containers are opened with number of items (or without it, in which case
+ * they must be closed by end ()). Reader returns one item per call, strings are returned as string_view into
+ * the source buffer, so reading never allocates. Indefinite length strings can be skipped, but not read. */
+
+namespace shaga::CBOR {
+	enum class Type {
+		UNSIGNED,
+		NEGATIVE,
+		BYTES,
+		TEXT,
+		ARRAY,
+		MAP,
+		TAG,
+		BOOL,
+		NUL,
+		UNDEFINED,
+		FLOAT,
+		BREAK,
+		END
+	};
+
+	/* Number of items of indefinite length array or map */
+	static const constexpr size_t indefinite {SIZE_MAX};
+
+	static const constexpr size_t max_depth {256};
+
+	class Writer {
+		private:
+			std::vector<uint8_t> _buf;
+
+			void _head (const uint8_t major, const uint64_t val);
+
+		public:
+			Writer () = default;
+			explicit Writer (const size_t reserve_size);
+
+			/* Containers. With indefinite number of items, end () must be called after the last item. */
+			Writer & array (const size_t items = indefinite);
+			Writer & map (const size_t items = indefinite);
+			Writer & end (void);
+
+			Writer & tag (const uint64_t tag);
+
+			Writer & null (void);
+			Writer & value (const bool val);
+			Writer & value (const uint64_t val);
+			Writer & value (const int64_t val);
+			Writer & value (const double val);
+			Writer & value (const std::string_view val);
+			Writer & value (const char *const val);
+			Writer & bytes (const std::string_view val);
+			Writer & bytes (const void *const data, const size_t len);
+
+			template<typename T, SHAGA_TYPE_IS_INTEGER(T)>
+			Writer & value (const T val)
+			{
+				if constexpr (std::is_signed<T>::value) {
+					return value (static_cast<int64_t> (val));
+				}
+				else {
+					return value (static_cast<uint64_t> (val));
+				}
+			}
+
+			/* Map entry with text key */
+			template<typename T>
+			Writer & entry (const std::string_view key, const T &val)
+			{
+				value (key);
+				return value (val);
+			}
+
+			size_t size (void) const;
+			bool empty (void) const;
+			/* Drop content, keep allocated memory */
+			void clear (void);
+
+			const std::vector<uint8_t> & data (void) const;
+			/* Move encoded data out, e.g. to Chunk::set_cbor () */
+			std::vector<uint8_t> release (void);
+	};
+
+	class Reader {
+		private:
+			std::string_view _buf;
+			size_t _offset {0};
+
+			uint8_t _peek_byte (void) const;
+			uint64_t _head (const uint8_t expected_major, uint8_t &info);
+			uint64_t _argument (const uint8_t info);
+			size_t _container (const uint8_t major);
+			std::string_view _string (const uint8_t major);
+			void _skip (const size_t depth);
+
+		public:
+			Reader () = default;
+			explicit Reader (const std::string_view buf);
+			explicit Reader (const std::vector<uint8_t> &buf);
+
+			/* Type of the next item, END if there is no more data */
+			Type peek (void) const;
+			bool at_end (void) const;
+			size_t get_offset (void) const;
+
+			uint64_t read_uint (void);
+			int64_t read_int (void);
+			/* Floating point, integers are converted */
+			double read_double (void);
+			bool read_bool (void);
+			void read_null (void);
+			uint64_t read_tag (void);
+
+			SHAGA_STRV std::string_view read_text (void);
+			SHAGA_STRV std::string_view read_bytes (void);
+
+			/* Number of items, or indefinite. Items of indefinite container are followed by break. */
+			size_t read_array (void);
+			size_t read_map (void);
+			/* Returns true and consumes break if it is the next item */
+			bool read_break (void);
+
+			/* Skip one item including all nested items */
+			void skip (void);
+
+			/* Reader must be positioned at a map. Searches text keys and if key is found, reader is positioned
+			 * at its value and true is returned. Otherwise the whole map is skipped and false is returned. */
+			bool find_key (const std::string_view key);
+	};
+}
+
+#endif // HEAD_shaga_CBOR
@@ -12,6 +12,9 @@ All rights reserved.
 
 namespace shaga {
 	class ChunkTool;
+	class ChunkPool;
+	class ChunkShared;
+	class ChunkPack;
 
 	static constexpr uint32_t _chunk_key_to_bin_helper (const char str[5], const size_t pos)
 	{
@@ -46,6 +49,29 @@ namespace shaga {
 				uint8_t metric;
 			} TRACERT_HOP;
 
+			/* Read-only view of tracert hops stored inside the Chunk, valid until the Chunk is modified or destroyed */
+			class TracertHops
+			{
+				private:
+					const TRACERT_HOP *_ptr {nullptr};
+					size_t _size {0};
+
+				public:
+					TracertHops () = default;
+					TracertHops (const TRACERT_HOP *const ptr, const size_t sze) : _ptr (ptr), _size (sze) {}
+
+					const TRACERT_HOP* data (void) const { return _ptr; }
+					size_t size (void) const { return _size; }
+					bool empty (void) const { return 0 == _size; }
+
+					const TRACERT_HOP* begin (void) const { return _ptr; }
+					const TRACERT_HOP* end (void) const { return _ptr + _size; }
+					const TRACERT_HOP* cbegin (void) const { return _ptr; }
+					const TRACERT_HOP* cend (void) const { return _ptr + _size; }
+
+					const TRACERT_HOP& operator[] (const size_t pos) const { return _ptr[pos]; }
+			};
+
 			enum class TrustLevel : uint32_t {
 				INTERNAL = 0,
 				TRUSTED,
@@ -135,18 +161,41 @@ namespace shaga {
 			uint_fast64_t _counter{0};
 			uint_fast8_t _ttl{max_ttl};
 			HWIDMASK _hwid_dest;
-			std::list<TRACERT_HOP> _tracert_hops;
+			std::array<TRACERT_HOP, max_hop_counter> _tracert_hops {};
+			uint_fast8_t _tracert_hops_count {0};
 
 			mutable std::string _stored_binary;
 			mutable size_t _stored_header_size{0};
 
 			bool should_continue (const std::string_view s, const size_t offset) const;
 			uint32_t generate_header (char *const out, size_t &offset, const SPECIAL_TYPES *const special_types) const;
+			uint32_t _generate_header (char *const out, size_t &offset, const SPECIAL_TYPES *const special_types, const bool with_payload, const bool with_cbor, const bool with_source) const;
+			/* Binary representation is split to head (header, source, tracert hops and destination) and body (payload, CBOR and meta) */
+			void _head_to_bin (std::string &out_append, const SPECIAL_TYPES *const special_types, const bool with_payload, const bool with_cbor) const;
+			void _hops_to_bin (std::string &out_append) const;
+			void _body_to_bin (std::string &out_append) const;
+
+			/* Parts of from_bin (), _header_from_bin () reads header without source and returns its bits */
+			uint32_t _header_from_bin (const std::string_view bin, size_t &offset, const SPECIAL_TYPES *const special_types);
+			void _hops_from_bin (const std::string_view bin, size_t &offset);
+			void _body_from_bin (const std::string_view bin, size_t &offset, const uint32_t val);
 
 			void _reset (void);
+			/* Same as _reset () and from_bin (), but counter is kept */
+			void _clear (void);
+			void _from_bin (const std::string_view bin, size_t &offset, const SPECIAL_TYPES *const special_types, bool store_binary_representation);
+			/* Bytes allocated by containers of this chunk */
+			size_t _get_capacity (void) const;
+
+			/* Reserve cnt consecutive counters, returns the first one */
+			static uint_fast64_t _reserve_counters (const size_t cnt);
 
 			void _construct (void);
 
+			/* Empty chunk with given counter, doesn't take a new one */
+			struct _KeepCounter {};
+			Chunk (const _KeepCounter, const uint_fast64_t counter);
+
 			template <typename... Types>
 			void _construct (const std::string_view payload, Types &&...rest)
 			{
@@ -279,6 +328,11 @@ namespace shaga {
 				_construct (rest...);
 			}
 
+			/* Reuse chunk as if it was newly constructed. Content is cleared, but allocated memory is kept. */
+			void reset (const HWID hwid_source, const std::string_view type);
+			void reset (const HWID hwid_source, const uint32_t type);
+			void from_bin (const std::string_view bin, size_t &offset, const SPECIAL_TYPES *const special_types = nullptr, bool store_binary_representation = false);
+
 			/* Returns number of bytes needed to store this chunk in binary format. May return more than actually needed but never less. */
 			size_t get_max_bytes (void) const;
 
@@ -326,6 +380,8 @@ namespace shaga {
 
 			nlohmann::json get_json (void) const;
 			const std::vector<uint8_t> &get_cbor (void) const;
+			/* Pull reader over CBOR data, valid until CBOR is changed */
+			CBOR::Reader get_cbor_reader (void) const;
 
 			/* Priority */
 			void set_prio (const Priority prio);
@@ -348,7 +404,7 @@ namespace shaga {
 
 			/* Tracert */
 			bool tracert_hops_add (const shaga::HWID hwid, const uint8_t metric);
-			std::list<TRACERT_HOP> tracert_hops_get (void) const;
+			TracertHops tracert_hops_get (void) const;
 			size_t tracert_hops_count (void) const;
 
 			/* Destination */
@@ -373,12 +429,17 @@ namespace shaga {
 			/* These methods (to_bin) don't use stored binary version, they always generate output */
 			void to_bin (std::string &out_append, const SPECIAL_TYPES *const special_types = nullptr) const;
 			std::string to_bin (const SPECIAL_TYPES *const special_types = nullptr) const;
+			/* Write to raw buffer, which must have at least get_max_bytes () available at offset */
+			void to_bin (char *const out, size_t &offset, const SPECIAL_TYPES *const special_types = nullptr) const;
 
 			friend bool operator== (const Chunk &a, const Chunk &b);
 			friend bool operator!= (const Chunk &a, const Chunk &b);
 			friend bool operator< (const Chunk &a, const Chunk &b);
 
 			friend ChunkTool;
+			friend ChunkPool;
+			friend ChunkShared;
+			friend ChunkPack;
 	};
 }  // namespace shaga
 
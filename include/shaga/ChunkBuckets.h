@@ -0,0 +1,79 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#ifndef HEAD_shaga_ChunkBuckets
+#define HEAD_shaga_ChunkBuckets
+
+#include "common.h"
+
+namespace shaga {
+	/* Common part of ChunkPrioSet and ChunkPrioQueue, chunks are stored in one deque per priority. Derived classes
+	 * only decide where in the bucket new chunk is inserted. */
+	class ChunkBuckets {
+		public:
+			static const constexpr size_t num_buckets {static_cast<size_t> (Chunk::_Priority_last) + 1};
+
+			class const_iterator {
+				friend class ChunkBuckets;
+
+				private:
+					const ChunkBuckets *_owner {nullptr};
+					size_t _bucket {0};
+					size_t _pos {0};
+
+					const_iterator (const ChunkBuckets *const owner, const size_t bucket, const size_t pos);
+					void _skip_empty (void);
+
+				public:
+					typedef std::forward_iterator_tag iterator_category;
+					typedef Chunk value_type;
+					typedef std::ptrdiff_t difference_type;
+					typedef const Chunk * pointer;
+					typedef const Chunk & reference;
+
+					const_iterator () = default;
+
+					reference operator* (void) const;
+					pointer operator-> (void) const;
+					const_iterator & operator++ (void);
+					const_iterator operator++ (int);
+
+					bool operator== (const const_iterator &other) const;
+					bool operator!= (const const_iterator &other) const;
+			};
+
+		protected:
+			std::array<std::deque<Chunk>, num_buckets> _buckets;
+			size_t _size {0};
+
+			static size_t _bucket_index (const Chunk::Priority prio);
+
+			ChunkBuckets () = default;
+
+		public:
+			size_t size (void) const;
+			bool empty (void) const;
+			void clear (void);
+
+			const std::deque<Chunk> & bucket (const Chunk::Priority prio) const;
+			size_t bucket_size (const Chunk::Priority prio) const;
+
+			/* Erase first cnt chunks from bucket with given priority */
+			void erase_front (const Chunk::Priority prio, const size_t cnt);
+			/* Keep only first cnt chunks in bucket with given priority */
+			void truncate (const Chunk::Priority prio, const size_t cnt);
+
+			/* Erase all chunks for which callback returns false, relative order of the rest is kept */
+			void purge (std::function<bool (const Chunk &)> callback);
+
+			/* Iteration from the highest to the lowest priority */
+			const_iterator begin (void) const;
+			const_iterator end (void) const;
+	};
+}
+
+#endif // HEAD_shaga_ChunkBuckets
@@ -0,0 +1,60 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#ifndef HEAD_shaga_ChunkDedup
+#define HEAD_shaga_ChunkDedup
+
+#include "common.h"
+
+namespace shaga {
+	/* Time bounded filter of recently seen chunks, used to drop copies of the same chunk arriving over several paths.
+	 * Every chunk is reduced to 64-bit SipHash of its binary representation. TTL and tracert hops are excluded,
+	 * because they change on the way. Hashes are stored in two generations of fixed size open addressing tables,
+	 * when the current generation is full or older than period, the older one is dropped, so every chunk is remembered
+	 * for at least one period (unless more than capacity chunks arrive in that period) and at most two periods.
+	 * Memory is allocated only in constructor, check is O(1). False positive means collision of 64-bit hashes. */
+	class ChunkDedup {
+		private:
+			static const constexpr size_t _max_probe {16};
+
+			Digest::SipHash128_t _key;
+			const size_t _capacity;
+			const uint64_t _period_msec;
+			const Chunk::SPECIAL_TYPES *const _special_types;
+
+			size_t _mask {0};
+			std::array<std::vector<uint64_t>, 2> _gen;
+			std::array<size_t, 2> _gen_size {0, 0};
+			size_t _current {0};
+			uint64_t _rotated_msec {UINT64_MAX};
+
+			std::string _temp_bin;
+
+			uint64_t _hash (const ChunkView &view) const;
+			bool _contains (const size_t gen, const uint64_t hash) const;
+			bool _insert (const size_t gen, const uint64_t hash);
+			void _rotate (const uint64_t now_msec);
+
+		public:
+			/* Capacity is number of chunks remembered per generation */
+			ChunkDedup (const size_t capacity, const uint64_t period_msec, const Chunk::SPECIAL_TYPES *const special_types = nullptr);
+			ChunkDedup (const size_t capacity, const uint64_t period_msec, const Digest::SipHash128_t &key, const Chunk::SPECIAL_TYPES *const special_types = nullptr);
+
+			/* Returns true if the same chunk was seen recently, otherwise remembers it and returns false */
+			bool is_duplicate (const ChunkView &view, const uint64_t now_msec = get_monotime_msec ());
+			bool is_duplicate (const Chunk &chunk, const uint64_t now_msec = get_monotime_msec ());
+			/* Check chunk at offset of buf without decoding it, offset is moved after the chunk */
+			bool is_duplicate (const std::string_view buf, size_t &offset, const uint64_t now_msec = get_monotime_msec ());
+
+			/* Forget all chunks */
+			void clear (void);
+			/* Number of remembered chunks */
+			size_t size (void) const;
+	};
+}
+
+#endif // HEAD_shaga_ChunkDedup
@@ -0,0 +1,163 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#ifndef HEAD_shaga_ChunkDispatch
+#define HEAD_shaga_ChunkDispatch
+
+#include "common.h"
+
+namespace shaga {
+	/* Dispatch table from chunk type to handler. Table is built by the constructor, which is constexpr, so when
+	 * dispatcher is declared as constexpr, perfect hash is found by the compiler and invalid or duplicate types
+	 * fail the build:
+	 *
+	 *   static constexpr ChunkDispatch<Context, 2> dispatch ({{
+	 *       {ChKEY ("ABCD"), [](Context &ctx, const Chunk &chunk) -> void { ... }},
+	 *       {ChKEY ("EFGH"), &handle_efgh},
+	 *   }});
+	 *
+	 * Lookup is one multiplication, one shift and one compare, handlers are plain function pointers.
+	 * T can be any type with get_num_type (), e.g. Chunk or ChunkView. */
+	template<class Context, size_t N, class T = Chunk>
+	class ChunkDispatch
+	{
+		static_assert (N > 0, "At least one handler must be registered");
+
+		public:
+			typedef void (*Handler) (Context &ctx, const T &chunk);
+
+			struct Entry {
+				uint32_t type;
+				Handler handler;
+			};
+
+		private:
+			static constexpr size_t _min_bits (void)
+			{
+				size_t bits = 0;
+				while ((static_cast<size_t> (1) << bits) < N) {
+					++bits;
+				}
+				return bits + 1;
+			}
+
+			/* Table is between 2x and 32x larger than number of handlers */
+			static const constexpr size_t _max_bits {_min_bits () + 4};
+			static const constexpr size_t _table_size {static_cast<size_t> (1) << _max_bits};
+			static const constexpr size_t _tries_per_size {512};
+
+			std::array<uint32_t, _table_size> _types {};
+			std::array<Handler, _table_size> _handlers {};
+			Handler _fallback {nullptr};
+			uint32_t _mul {0};
+			uint32_t _shift {0};
+
+			constexpr size_t _slot (const uint32_t type) const
+			{
+				return static_cast<uint32_t> (type * _mul) >> _shift;
+			}
+
+			constexpr bool _try_build (const std::array<Entry, N> &entries, const size_t bits, const uint32_t mul)
+			{
+				_mul = mul;
+				_shift = 32 - bits;
+
+				for (size_t i = 0; i < _table_size; ++i) {
+					_types[i] = 0;
+					_handlers[i] = nullptr;
+				}
+
+				for (const Entry &e : entries) {
+					const size_t pos = _slot (e.type);
+					if (nullptr != _handlers[pos]) {
+						return false;
+					}
+					_types[pos] = e.type;
+					_handlers[pos] = e.handler;
+				}
+				return true;
+			}
+
+		public:
+			/* Fallback is called for types without handler, it may be nullptr */
+			constexpr explicit ChunkDispatch (const std::array<Entry, N> &entries, const Handler fallback = nullptr) :
+				_fallback (fallback)
+			{
+				for (size_t i = 0; i < N; ++i) {
+					if (entries[i].type < Chunk::key_type_min || entries[i].type > Chunk::key_type_max) {
+						cThrow ("Invalid chunk type"sv);
+					}
+					if (nullptr == entries[i].handler) {
+						cThrow ("Handler is not defined"sv);
+					}
+					for (size_t j = 0; j < i; ++j) {
+						if (entries[i].type == entries[j].type) {
+							cThrow ("Duplicate chunk type"sv);
+						}
+					}
+				}
+
+				for (size_t bits = _min_bits (); bits <= _max_bits; ++bits) {
+					/* Odd multipliers from fixed LCG sequence, so the table is the same on every build */
+					uint32_t mul = 0x9E3779B1;
+					for (size_t tr = 0; tr < _tries_per_size; ++tr) {
+						if (_try_build (entries, bits, mul | 1) == true) {
+							return;
+						}
+						mul = mul * 1664525 + 1013904223;
+					}
+				}
+
+				cThrow ("Unable to build dispatch table"sv);
+			}
+
+			/* Handler for given type, fallback if type is not registered */
+			constexpr Handler find (const uint32_t type) const
+			{
+				const size_t pos = _slot (type);
+				return (_types[pos] == type && nullptr != _handlers[pos]) ? _handlers[pos] : _fallback;
+			}
+
+			constexpr bool contains (const uint32_t type) const
+			{
+				const size_t pos = _slot (type);
+				return (_types[pos] == type && nullptr != _handlers[pos]);
+			}
+
+			/* Call handler for one chunk. Returns false if there is no handler and no fallback. */
+			bool dispatch (Context &ctx, const T &chunk) const
+			{
+				const Handler handler = find (chunk.get_num_type ());
+				if (nullptr == handler) {
+					return false;
+				}
+				handler (ctx, chunk);
+				return true;
+			}
+
+			/* Call handlers for all chunks in range. Returns number of chunks that were handled. */
+			template<class Iter>
+			size_t dispatch (Context &ctx, Iter first, const Iter last) const
+			{
+				size_t cnt {0};
+				for (; first != last; ++first) {
+					if (dispatch (ctx, *first) == true) {
+						++cnt;
+					}
+				}
+				return cnt;
+			}
+
+			template<class C>
+			size_t dispatch_all (Context &ctx, const C &chunks) const
+			{
+				return dispatch (ctx, std::cbegin (chunks), std::cend (chunks));
+			}
+	};
+}
+
+#endif // HEAD_shaga_ChunkDispatch
@@ -11,11 +11,15 @@ All rights reserved.
 #include "common.h"
 
 namespace shaga {
-	/* ChunkMeta is key-value structure with repeating key allowed.	Every key has to be three capital letters ('A' to 'Z'). */
+	/* ChunkMeta is key-value structure with repeating key allowed.	Every key has to be three capital letters ('A' to 'Z').
+	 * Entries are stored in flat vector sorted by key, repeated keys are kept in order of insertion. Chunks usually
+	 * carry just a few entries, so contiguous storage is faster than hashing and values up to SSO size of std::string
+	 * don't allocate at all. Storage is sorted on every modification, so const methods never change it. */
 	class Chunk;
 
-	using ChunkMetaData = std::unordered_multimap<uint_fast16_t, std::string>;
-	using ChunkMetaDataSet = std::set<std::pair<uint_fast16_t, std::string>>;
+	using ChunkMetaEntry = std::pair<uint_fast16_t, std::string>;
+	using ChunkMetaData = std::vector<ChunkMetaEntry>;
+	using ChunkMetaDataSet = std::set<ChunkMetaEntry>;
 	using ChunkMetaDataRange = std::pair<ChunkMetaData::const_iterator, ChunkMetaData::const_iterator>;
 
 	static constexpr uint16_t _chunkmeta_key_to_bin_helper (const char str[4], const size_t pos)
@@ -66,6 +70,56 @@ namespace shaga {
 			ChunkMetaData _data;
 
 			bool should_continue (const std::string_view s, const size_t offset) const noexcept;
+
+			std::pair<ChunkMetaData::iterator, ChunkMetaData::iterator> _equal_range (const uint16_t key) noexcept;
+			void _emplace (const uint16_t key, std::string &&value);
+
+			std::optional<uint32_t> _get_uint24 (const uint16_t key) const noexcept;
+
+			/* Numbers use the same little endian encoding as add_* methods. Existing string is reused,
+			 * so its buffer is not reallocated. */
+			template<typename T, SHAGA_TYPE_IS_INTEGER(T)>
+			static void _set_number (const T value, std::string &out)
+			{
+				using UnsignedT = std::make_unsigned_t<T>;
+				out.resize (sizeof (T));
+				if constexpr (sizeof (T) == sizeof (uint8_t)) {
+					BIN::_from_uint8 (static_cast<UnsignedT> (value), out.data ());
+				}
+				else if constexpr (sizeof (T) == sizeof (uint16_t)) {
+					BIN::_from_uint16 (static_cast<UnsignedT> (value), out.data ());
+				}
+				else if constexpr (sizeof (T) == sizeof (uint32_t)) {
+					BIN::_from_uint32 (static_cast<UnsignedT> (value), out.data ());
+				}
+				else {
+					BIN::_from_uint64 (static_cast<UnsignedT> (value), out.data ());
+				}
+			}
+
+			template<typename T, SHAGA_TYPE_IS_INTEGER(T)>
+			std::optional<T> _get_number (const uint16_t key) const noexcept
+			{
+				ChunkMetaData::const_iterator iter = find (key);
+				if (iter == cend () || iter->second.size () < sizeof (T)) {
+					return std::nullopt;
+				}
+
+				const char *const data = iter->second.data ();
+				if constexpr (sizeof (T) == sizeof (uint8_t)) {
+					return static_cast<T> (BIN::_to_uint8 (data));
+				}
+				else if constexpr (sizeof (T) == sizeof (uint16_t)) {
+					return static_cast<T> (BIN::_to_uint16 (data));
+				}
+				else if constexpr (sizeof (T) == sizeof (uint32_t)) {
+					return static_cast<T> (BIN::_to_uint32 (data));
+				}
+				else {
+					return static_cast<T> (BIN::_to_uint64 (data));
+				}
+			}
+
 		public:
 			ChunkMeta ();
 			ChunkMeta (const uint16_t key);
@@ -205,6 +259,8 @@ namespace shaga {
 			void add_int64 (const std::string_view key, const int64_t value);
 
 			size_t get_max_bytes (void) const noexcept;
+			/* Bytes allocated for entries, kept after clear () */
+			size_t get_capacity (void) const noexcept;
 
 			size_t size (void) const noexcept;
 			size_t count (const std::string_view key) const;
@@ -233,7 +289,7 @@ namespace shaga {
 			{
 				T vout;
 
-				auto [i_begin, i_end] = _data.equal_range (key);
+				auto [i_begin, i_end] = equal_range (key);
 				for (auto iter = i_begin; iter != i_end; ++iter) {
 					vout.push_back (iter->second);
 				}
@@ -251,15 +307,25 @@ namespace shaga {
 				return get_value<T> (key_to_bin (key));
 			}
 
+			/* Integer types are decoded from binary, missing or too short value returns 0 */
 			template<typename T = std::string_view>
 			SHAGA_STRV T get_value (const uint16_t key) const
 			{
-				ChunkMetaData::const_iterator iter = _data.find (key);
-				if (iter != _data.cend ()) {
-					return iter->second;
+				using CleanT = std::remove_cv_t<std::remove_reference_t<T>>;
+				if constexpr (std::is_same_v<CleanT, bool>) {
+					return (0 != _get_number<uint8_t> (key).value_or (0));
+				}
+				else if constexpr (std::is_integral_v<CleanT>) {
+					return _get_number<CleanT> (key).value_or (0);
 				}
+				else {
+					ChunkMetaData::const_iterator iter = find (key);
+					if (iter != _data.cend ()) {
+						return iter->second;
+					}
 
-				return T(""sv);
+					return T(""sv);
+				}
 			}
 
 			template <typename T = std::string_view>
@@ -271,12 +337,51 @@ namespace shaga {
 			template <typename T = std::string_view>
 			SHAGA_STRV std::optional<T> get_value_optional (const uint16_t key) const
 			{
-				ChunkMetaData::const_iterator iter = _data.find (key);
-				if (iter != _data.cend ()) {
-					return iter->second;
+				using CleanT = std::remove_cv_t<std::remove_reference_t<T>>;
+				if constexpr (std::is_same_v<CleanT, bool>) {
+					const auto val = _get_number<uint8_t> (key);
+					if (val.has_value () == false) {
+						return std::nullopt;
+					}
+					return (0 != *val);
+				}
+				else if constexpr (std::is_integral_v<CleanT>) {
+					return _get_number<CleanT> (key);
+				}
+				else {
+					ChunkMetaData::const_iterator iter = find (key);
+					if (iter != _data.cend ()) {
+						return iter->second;
+					}
+
+					return std::nullopt;
+				}
+			}
+
+			/* Overwrite first value of the key in place, or add it if key doesn't exist.
+			 * Useful for counters and sequence numbers, which change on every hop. */
+			template<typename T, SHAGA_TYPE_IS_SUPPORTED_xINTBOOL(T)>
+			void set_value (const uint16_t key, const T value)
+			{
+				auto [i_begin, i_end] = _equal_range (key);
+				if (i_begin == i_end) {
+					add_value (key, value);
+					return;
+				}
+
+				using CleanT = std::remove_cv_t<std::remove_reference_t<T>>;
+				if constexpr (std::is_same_v<CleanT, bool>) {
+					_set_number<uint8_t> (value ? 1 : 0, i_begin->second);
+				}
+				else {
+					_set_number<CleanT> (value, i_begin->second);
 				}
+			}
 
-				return std::nullopt;
+			template<typename T, SHAGA_TYPE_IS_SUPPORTED_xINTBOOL(T)>
+			void set_value (const std::string_view key, const T value)
+			{
+				set_value (key_to_bin (key), value);
 			}
 
 			bool get_bool (const std::string_view key, const bool default_value) const;
@@ -360,6 +465,8 @@ namespace shaga {
 
 			void to_bin (std::string &out_append) const;
 			std::string to_bin (void) const;
+			/* Write to raw buffer, which must have at least get_max_bytes () available at offset */
+			void to_bin (char *const out, size_t &offset) const;
 
 			void from_bin (const std::string_view s, size_t &offset);
 	};
@@ -0,0 +1,110 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#ifndef HEAD_shaga_ChunkPack
+#define HEAD_shaga_ChunkPack
+
+#include "common.h"
+
+/* Packed batch of chunks, alternative to concatenated output of ChunkTool::to_bin () for links where every byte counts.
+ * Source HWID and destination shared by most chunks are stored once per batch, every chunk stores them only if they
+ * differ. Batch starts with index of record sizes, so chunks can be located and decoded one by one without parsing
+ * the whole batch. Records may be compressed by LZ as one block, without dictionary, so every batch is independent.
+ *
+ * Batch:
+ *   uint8      version (high 4 bits) and flags
+ *   size       number of records
+ *   HWID       common source
+ *   HWIDMASK   common destination (mask, hwid), only with flag_common_dest
+ *   size       index entry for every record, (record size << 2) | record flags
+ *   size       size of LZ frame and the frame, only with flag_compressed
+ *   records    otherwise records follow directly
+ *
+ * Record is the same as binary chunk, but without source HWID and destination, unless they are marked by record flags.
+ * Meta of the record ends with the record. */
+
+namespace shaga {
+	class ChunkPack {
+		public:
+			static const constexpr uint8_t version {1};
+
+			static const constexpr uint8_t flag_compressed {0b0001};
+			static const constexpr uint8_t flag_common_dest {0b0010};
+
+			static const constexpr uint_fast8_t record_source {0b01};
+			static const constexpr uint_fast8_t record_dest {0b10};
+
+			/* One decoded batch, records are decoded to chunks on demand */
+			class Batch {
+				private:
+					const Chunk::SPECIAL_TYPES *_special_types {nullptr};
+					HWID _source {HWID_UNKNOWN};
+					std::optional<HWIDMASK> _dest;
+					std::string _records;
+					/* Offsets of records, there is one extra offset marking the end of the last record */
+					std::vector<size_t> _offsets;
+					std::vector<uint8_t> _flags;
+
+					friend ChunkPack;
+
+				public:
+					Batch () = default;
+
+					/* Drop all records, keep allocated memory */
+					void clear (void);
+
+					size_t size (void) const;
+					bool empty (void) const;
+
+					void get (const size_t pos, Chunk &out) const;
+					Chunk get (const size_t pos) const;
+
+					/* Size of packed record */
+					size_t get_record_size (const size_t pos) const;
+			};
+
+		private:
+			const Chunk::SPECIAL_TYPES *const _special_types {nullptr};
+			const bool _compress;
+
+			LZ::Compressor _compressor {false};
+			std::string _records;
+			std::string _frame;
+			std::vector<size_t> _index;
+
+			static uint_fast8_t _record_to_bin (const Chunk &chunk, const HWID source, const std::optional<HWIDMASK> &dest, std::string &out_append, const Chunk::SPECIAL_TYPES *const special_types);
+			static void _record_from_bin (const std::string_view record, const uint_fast8_t flags, const HWID source, const std::optional<HWIDMASK> &dest, Chunk &out, const Chunk::SPECIAL_TYPES *const special_types);
+
+			template <class T>
+			void _to_bin (T &lst_erase, std::string &out_append, const size_t max_size, const Chunk::Priority max_priority, const bool erase_skipped);
+
+			template <class T>
+			void _from_bin (const std::string_view buf, size_t &offset, T &out_append) const;
+
+		public:
+			explicit ChunkPack (const bool compress = true, const Chunk::SPECIAL_TYPES *const special_types = nullptr);
+
+			/* Chunks are packed to one batch and erased from the list, same as with ChunkTool::to_bin (). Chunks with priority
+			 * above max_priority are skipped and kept, unless erase_skipped is set. If max_size is set, packing stops before
+			 * the first chunk that would make uncompressed batch larger, exception is thrown if not even the first one fits.
+			 * Common source and destination are the most used ones among chunks up to max_priority. */
+			void to_bin (CHUNKLIST &lst_erase, std::string &out_append, const size_t max_size = 0, const Chunk::Priority max_priority = Chunk::Priority::pDEBUG, const bool erase_skipped = false);
+			std::string to_bin (CHUNKLIST &lst_erase, const size_t max_size = 0, const Chunk::Priority max_priority = Chunk::Priority::pDEBUG, const bool erase_skipped = false);
+
+			void to_bin (CHUNKDEQUE &lst_erase, std::string &out_append, const size_t max_size = 0, const Chunk::Priority max_priority = Chunk::Priority::pDEBUG, const bool erase_skipped = false);
+			std::string to_bin (CHUNKDEQUE &lst_erase, const size_t max_size = 0, const Chunk::Priority max_priority = Chunk::Priority::pDEBUG, const bool erase_skipped = false);
+
+			/* Decode one batch at offset. On error, out is empty and offset is not changed. */
+			void decode (const std::string_view buf, size_t &offset, Batch &out) const;
+
+			/* Decode all chunks of one batch. On error, out_append and offset are not changed. */
+			void from_bin (const std::string_view buf, size_t &offset, CHUNKLIST &out_append) const;
+			void from_bin (const std::string_view buf, size_t &offset, CHUNKDEQUE &out_append) const;
+	};
+}
+
+#endif // HEAD_shaga_ChunkPack
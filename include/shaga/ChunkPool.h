@@ -0,0 +1,64 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#ifndef HEAD_shaga_ChunkPool
+#define HEAD_shaga_ChunkPool
+
+#include "common.h"
+
+namespace shaga {
+	/* Pool of recycled chunks. Chunks are handed out as Handle (unique_ptr with custom deleter), which returns
+	 * the chunk to the pool when released. Returned chunk keeps capacity of payload, CBOR, meta and stored binary
+	 * representation, so once the pool is warmed up, creating and decoding chunks of similar size doesn't allocate.
+	 * Handles keep the pool storage alive, so they may outlive ChunkPool object and may be released from any thread. */
+	class ChunkPool {
+		private:
+			struct _Storage;
+			std::shared_ptr<_Storage> _storage;
+
+			Chunk * _acquire (void);
+
+		public:
+			class Deleter {
+				private:
+					std::shared_ptr<_Storage> _storage;
+
+				public:
+					Deleter () = default;
+					explicit Deleter (const std::shared_ptr<_Storage> &storage);
+
+					void operator() (Chunk *const chunk) const;
+			};
+
+			typedef std::unique_ptr<Chunk, Deleter> Handle;
+
+			/* At most max_size free chunks are kept. Chunks with more than max_chunk_bytes allocated are dropped
+			 * instead of returned, so one large chunk doesn't hold memory forever (0 means no limit). */
+			explicit ChunkPool (const size_t max_size = 1024, const size_t max_chunk_bytes = 0);
+
+			/* Disable copy and assignment */
+			ChunkPool (const ChunkPool &) = delete;
+			ChunkPool& operator= (const ChunkPool &) = delete;
+
+			Handle get (const HWID hwid_source, const std::string_view type);
+			Handle get (const HWID hwid_source, const uint32_t type);
+			/* Decode chunk into recycled one */
+			Handle get (const std::string_view bin, size_t &offset, const Chunk::SPECIAL_TYPES *const special_types = nullptr, const bool store_binary_representation = false);
+
+			/* Keep memory of chunk that is not needed anymore, e.g. one taken out of CHUNKLIST */
+			void recycle (Chunk &&chunk);
+
+			/* Number of free chunks in the pool */
+			size_t size (void) const;
+			/* Number of chunks allocated by the pool, stops growing once the pool covers the flow */
+			size_t get_allocations (void) const;
+			/* Free all chunks in the pool */
+			void clear (void);
+	};
+}
+
+#endif // HEAD_shaga_ChunkPool
@@ -0,0 +1,43 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#ifndef HEAD_shaga_ChunkPrioQueue
+#define HEAD_shaga_ChunkPrioQueue
+
+#include "common.h"
+
+namespace shaga {
+	/* Outbound queue with one FIFO per priority. Chunks of the same priority are kept in order of push, so push, front
+	 * and pop are O(1) and trimming drops tails of the lowest priority buckets without walking them.
+	 *
+	 * Order is not the same as in CHUNKSET, so ChunkTool::to_bin () of the queue emits chunks in a different order than
+	 * of CHUNKSET with the same content. Chunks of the same priority are not ordered by trust level, and OPTIONAL
+	 * and DEBUG chunks are not grouped by source, type and destination with the newest first. */
+	class ChunkPrioQueue : public ChunkBuckets {
+		private:
+			size_t _first_bucket (void) const;
+
+		public:
+			ChunkPrioQueue () = default;
+
+			void push (const Chunk &chunk);
+			void push (Chunk &&chunk);
+
+			template <class... Args>
+			void emplace (Args &&...args)
+			{
+				push (Chunk (std::forward<Args> (args)...));
+			}
+
+			/* Oldest chunk with the highest priority */
+			const Chunk & front (void) const;
+			Chunk & front (void);
+			void pop_front (void);
+	};
+}
+
+#endif // HEAD_shaga_ChunkPrioQueue
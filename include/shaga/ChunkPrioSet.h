@@ -0,0 +1,33 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#ifndef HEAD_shaga_ChunkPrioSet
+#define HEAD_shaga_ChunkPrioSet
+
+#include "common.h"
+
+namespace shaga {
+	/* Replacement of CHUNKSET without node per chunk. Chunks are stored in one deque per priority, every bucket is kept
+	 * sorted the same way as CHUNKSET (equal chunks in order of insertion). Chunks inserted in order are appended in O(1),
+	 * others are placed by binary search. Erasing from the front of bucket doesn't move remaining chunks.
+	 * Iteration is in the same order as CHUNKSET. */
+	class ChunkPrioSet : public ChunkBuckets {
+		public:
+			ChunkPrioSet () = default;
+
+			void insert (const Chunk &chunk);
+			void insert (Chunk &&chunk);
+
+			template <class... Args>
+			void emplace (Args &&...args)
+			{
+				insert (Chunk (std::forward<Args> (args)...));
+			}
+	};
+}
+
+#endif // HEAD_shaga_ChunkPrioSet
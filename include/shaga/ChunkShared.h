@@ -0,0 +1,89 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#ifndef HEAD_shaga_ChunkShared
+#define HEAD_shaga_ChunkShared
+
+#include "common.h"
+
+namespace shaga {
+	/* Chunk with immutable body (payload, CBOR and meta) shared by all copies, intended for sending the same chunk
+	 * to many destinations. Copy costs one reference count increment, only header fields (channel, priority,
+	 * trust level, TTL, tracert hops and destination) belong to the copy and may be changed.
+	 *
+	 * Body is serialized once when ChunkShared is created, to_bin () generates only the header and appends
+	 * stored body, so output is the same as Chunk::to_bin () of the original chunk with the same header.
+	 * Body is never modified after creation, so copies may be used from several threads. */
+	class ChunkShared {
+		private:
+			struct _Body;
+
+			/* Header fields, its payload, CBOR and meta are always empty */
+			Chunk _header;
+			std::shared_ptr<const _Body> _body;
+
+		public:
+			explicit ChunkShared (const Chunk &chunk);
+			explicit ChunkShared (Chunk &&chunk);
+
+			/* Copy of the original chunk with header of this copy */
+			Chunk to_chunk (void) const;
+
+			/* Number of copies sharing the body */
+			long use_count (void) const;
+
+			/* Header */
+			void set_channel (const bool is_primary);
+			bool is_primary_channel (void) const;
+
+			HWID get_source_hwid (void) const;
+			std::string get_type (void) const;
+			uint32_t get_num_type (void) const;
+
+			void set_prio (const Chunk::Priority prio);
+			Chunk::Priority get_prio (void) const;
+
+			void set_minimal_trustlevel (const Chunk::TrustLevel trust);
+			void set_trustlevel (const Chunk::TrustLevel trust);
+			Chunk::TrustLevel get_trustlevel (void) const;
+
+			void set_ttl (const uint8_t ttl);
+			void set_ttl (const Chunk::TTL ttl);
+			uint8_t get_ttl (void) const;
+			bool is_zero_ttl (void) const;
+			bool hop_ttl (void);
+
+			bool tracert_hops_add (const shaga::HWID hwid, const uint8_t metric);
+			Chunk::TracertHops tracert_hops_get (void) const;
+
+			HWIDMASK get_destination_hwidmask (void) const;
+			void set_destination_hwid (const HWID hwid);
+			void set_destination_hwid (const HWIDMASK &hwidmask);
+			void set_destination_broadcast (void);
+			bool is_for_destination (const HWID hwid) const;
+
+			/* Body, read only */
+			bool has_payload (void) const;
+			SHAGA_STRV std::string_view get_payload (void) const;
+
+			bool has_cbor (void) const;
+			SHAGA_STRV std::string_view get_cbor (void) const;
+			CBOR::Reader get_cbor_reader (void) const;
+			nlohmann::json get_json (void) const;
+
+			const ChunkMeta & get_meta (void) const;
+
+			/* Binary representation, body is appended from stored binary */
+			size_t get_max_bytes (void) const;
+			void to_bin (std::string &out_append, const Chunk::SPECIAL_TYPES *const special_types = nullptr) const;
+			std::string to_bin (const Chunk::SPECIAL_TYPES *const special_types = nullptr) const;
+	};
+
+	typedef std::list<ChunkShared> CHUNKSHAREDLIST;
+}
+
+#endif // HEAD_shaga_ChunkShared
@@ -0,0 +1,90 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#ifndef HEAD_shaga_ChunkSpecialTypes
+#define HEAD_shaga_ChunkSpecialTypes
+
+#include "common.h"
+
+namespace shaga {
+	/* Special types learned per link. Sending side counts types of outgoing chunks and propose () builds a new table
+	 * from the most frequent ones. New table is announced by control chunk carrying epoch and the table. Proposed
+	 * table stays pending until commit () appends the control chunk to the output, sender switches right after it
+	 * and receiver switches when it decodes it, so chunks sent before the switch still decode with the old table.
+	 * This requires ordered and reliable link (stream or packets processed in order), use one instance per
+	 * direction on each end.
+	 *
+	 * Sender:   cnt.count (chunk) for every sent chunk, periodically cnt.propose (hwid) and serialize using
+	 *           cnt.to_bin (chunks, out), which writes pending control chunk first.
+	 * Receiver: cnt.from_bin (buf, offset, lst) or cnt.apply (chunk) for every chunk decoded with cnt.get (). */
+	class ChunkSpecialTypes {
+		public:
+			/* Control chunk, never stored in the table */
+			static const constexpr uint32_t key_type_control = ChKEY ("SPTY");
+
+		private:
+			Chunk::SPECIAL_TYPES _table {};
+			uint32_t _epoch {0};
+			Chunk::SPECIAL_TYPES _pending_table {};
+			std::optional<Chunk> _pending;
+			const uint64_t _min_gain;
+			std::unordered_map<uint32_t, uint64_t> _counts;
+
+			bool _apply (const uint32_t type, const std::string_view payload);
+
+		public:
+			/* New table is proposed only if it saves at least min_gain bytes compared to the current one
+			 * (counted on recent traffic). Initial table must be the same on both ends. */
+			explicit ChunkSpecialTypes (const uint64_t min_gain = 1024);
+			ChunkSpecialTypes (const Chunk::SPECIAL_TYPES &initial_table, const uint64_t min_gain = 1024);
+
+			/* Current table, pointer stays valid and its content changes on switch */
+			const Chunk::SPECIAL_TYPES * get (void) const;
+			uint32_t get_epoch (void) const;
+
+			/* Sender side */
+			void count (const uint32_t type, const uint64_t cnt = 1);
+			void count (const Chunk &chunk);
+
+			template<class C>
+			void count_all (const C &chunks)
+			{
+				for (const auto &chunk : chunks) {
+					count (chunk.get_num_type ());
+				}
+			}
+
+			/* Returns true if new table is pending. Current table doesn't change until commit (), later proposal
+			 * replaces the pending one. Counts are halved on every call, so old traffic gradually loses weight. */
+			bool propose (const HWID hwid_source);
+			bool is_pending (void) const;
+
+			/* Appends pending control chunk and switches to the new table. Returns false if nothing was pending. */
+			bool commit (std::string &out_append);
+
+			/* Commits pending table and appends chunks serialized with the current table */
+			void to_bin (const Chunk &chunk, std::string &out_append);
+
+			template<class C>
+			void to_bin (const C &chunks, std::string &out_append)
+			{
+				commit (out_append);
+				for (const auto &chunk : chunks) {
+					chunk.to_bin (out_append, &_table);
+				}
+			}
+
+			/* Receiver side. Returns true if chunk is control chunk, in which case the table is switched. */
+			bool apply (const Chunk &chunk);
+			bool apply (const ChunkView &view);
+
+			/* Decode chunks using current table and switch on control chunks, which are not appended */
+			void from_bin (const std::string_view buf, size_t &offset, CHUNKLIST &out_append);
+	};
+}
+
+#endif // HEAD_shaga_ChunkSpecialTypes
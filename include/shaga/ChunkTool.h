@@ -13,6 +13,8 @@ All rights reserved.
 namespace shaga {
 	typedef std::list<Chunk> CHUNKLIST;
 	typedef std::multiset<Chunk> CHUNKSET;
+	/* Contiguous FIFO, cheaper to walk than CHUNKLIST */
+	typedef std::deque<Chunk> CHUNKDEQUE;
 
 	class ChunkTool {
 		private:
@@ -21,10 +23,23 @@ namespace shaga {
 			bool _enable_thr{true};
 			bool _store_binary{false};
 
-			std::string _temp_str;
 			std::string _out_str;
 
+			bool _append_chunk (const Chunk &chunk, std::string &out_append, const size_t start_size, const size_t max_size) const;
+
+			template <class T>
+			void _to_bin_buckets (T &cs_erase, std::string &out_append, const size_t max_size, const Chunk::Priority max_priority);
+
+			template <class T>
+			static void _trim_buckets (T &cset, const size_t treshold_size, const Chunk::Priority treshold_prio);
+
+			template <class T>
+			void _from_bin_parallel (const std::string_view buf, size_t &offset, T &out_append, const size_t max_threads) const;
+
 		public:
+			/* Parallel decoding doesn't start thread for less chunks than this */
+			static const constexpr size_t parallel_min_chunks {256};
+
 			ChunkTool (const bool enable_thr = true, const Chunk::SPECIAL_TYPES *const special_types = nullptr);
 			ChunkTool (const Chunk::SPECIAL_TYPES *const special_types);
 
@@ -34,6 +49,22 @@ namespace shaga {
 			/*** From binary string ***/
 			void from_bin (const std::string_view buf, size_t &offset, CHUNKLIST &out_append) const;
 			void from_bin (const std::string_view buf, size_t &offset, CHUNKSET &out_append) const;
+			void from_bin (const std::string_view buf, size_t &offset, CHUNKDEQUE &out_append) const;
+			void from_bin (const std::string_view buf, size_t &offset, ChunkPrioSet &out_append) const;
+			void from_bin (const std::string_view buf, size_t &offset, ChunkPrioQueue &out_append) const;
+
+			/* Views reference buf, which must outlive them */
+			void from_bin (const std::string_view buf, size_t &offset, CHUNKVIEWS &out_append) const;
+
+			/* Decoding of large buffers in two phases. Boundaries of chunks are found by ChunkView, which doesn't decode
+			 * them, then chunks are decoded by up to max_threads threads (0 means number of CPUs). Order and counters
+			 * of chunks are the same as with from_bin (). On error, out_append and offset are not changed. */
+			void from_bin_parallel (const std::string_view buf, size_t &offset, std::vector<Chunk> &out_append, const size_t max_threads = 0) const;
+			void from_bin_parallel (const std::string_view buf, size_t &offset, CHUNKDEQUE &out_append, const size_t max_threads = 0) const;
+
+			/* Replace content of the batch with all chunks in buf */
+			void from_bin (const std::string_view buf, ChunkBatch &out) const;
+			void from_bin (std::string &&buf, ChunkBatch &out) const;
 
 			template <class T, SHAGA_TYPE_IS_ITERABLE (T)>
 			void from_bin (const std::string_view buf, T &out_append) const
@@ -67,9 +98,24 @@ namespace shaga {
 			void to_bin (CHUNKSET &cs_erase, std::string &out_append, const size_t max_size = 0, const Chunk::Priority max_priority = Chunk::Priority::pDEBUG);
 			std::string to_bin (CHUNKSET &cs_erase, const size_t max_size = 0, const Chunk::Priority max_priority = Chunk::Priority::pDEBUG);
 
+			void to_bin (CHUNKDEQUE &lst_erase, std::string &out_append, const size_t max_size = 0, const Chunk::Priority max_priority = Chunk::Priority::pDEBUG, const bool erase_skipped = false);
+			std::string to_bin (CHUNKDEQUE &lst_erase, const size_t max_size = 0, const Chunk::Priority max_priority = Chunk::Priority::pDEBUG, const bool erase_skipped = false);
+
+			void to_bin (ChunkPrioSet &cs_erase, std::string &out_append, const size_t max_size = 0, const Chunk::Priority max_priority = Chunk::Priority::pDEBUG);
+			std::string to_bin (ChunkPrioSet &cs_erase, const size_t max_size = 0, const Chunk::Priority max_priority = Chunk::Priority::pDEBUG);
+
+			void to_bin (ChunkPrioQueue &cq_erase, std::string &out_append, const size_t max_size = 0, const Chunk::Priority max_priority = Chunk::Priority::pDEBUG);
+			std::string to_bin (ChunkPrioQueue &cq_erase, const size_t max_size = 0, const Chunk::Priority max_priority = Chunk::Priority::pDEBUG);
+
 			/*** Tools ***/
 			static void change_source_hwid (CHUNKLIST &lst, const HWID new_source_hwid, const bool replace_only_zero);
+			static void change_source_hwid (CHUNKDEQUE &lst, const HWID new_source_hwid, const bool replace_only_zero);
 			static void trim (CHUNKSET &cset, const size_t treshold_size, const Chunk::Priority treshold_prio);
+			static void trim (ChunkPrioSet &cset, const size_t treshold_size, const Chunk::Priority treshold_prio);
+			static void trim (ChunkPrioQueue &cq, const size_t treshold_size, const Chunk::Priority treshold_prio);
+
+			static void purge (ChunkPrioSet &cset, std::function<bool (const Chunk &)> callback);
+			static void purge (ChunkPrioQueue &cq, std::function<bool (const Chunk &)> callback);
 
 			/* Purge entry if callback returns false */
 			template <class T, SHAGA_TYPE_IS_ITERABLE (T)>
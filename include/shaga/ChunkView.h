@@ -0,0 +1,142 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#ifndef HEAD_shaga_ChunkView
+#define HEAD_shaga_ChunkView
+
+#include "common.h"
+
+namespace shaga {
+	/* Read-only view of one Chunk in binary format. Header is decoded when the view is constructed, payload, CBOR and
+	 * meta are only referenced as string_view into the source buffer and decoded when accessed.
+	 * Source buffer must outlive the view. */
+	class ChunkView {
+		private:
+			std::string_view _bin;
+			const Chunk::SPECIAL_TYPES *_special_types {nullptr};
+
+			uint32_t _val {0};
+			uint32_t _type {0};
+			HWID _hwid_source {HWID_UNKNOWN};
+			HWIDMASK _hwid_dest;
+			Chunk::Priority _prio {Chunk::Priority::pMANDATORY};
+			Chunk::TrustLevel _trust {Chunk::TrustLevel::INTERNAL};
+			uint_fast8_t _ttl {Chunk::max_ttl};
+			bool _channel {true};
+
+			size_t _header_size {0};
+			size_t _hops_offset {0};
+			uint_fast8_t _hops_count {0};
+
+			std::string_view _payload;
+			std::string_view _cbor;
+			std::string_view _meta;
+
+		public:
+			ChunkView () = default;
+			ChunkView (const std::string_view bin, size_t &offset, const Chunk::SPECIAL_TYPES *const special_types = nullptr);
+
+			/* Whole binary representation of the chunk, including header */
+			SHAGA_STRV std::string_view get_binary (void) const;
+			size_t get_header_size (void) const;
+
+			/* Channel */
+			bool is_primary_channel (void) const;
+			bool is_secondary_channel (void) const;
+			Chunk::Channel get_channel (void) const;
+			uint_fast8_t get_channel_bitmask (void) const;
+
+			/* Source and destination */
+			HWID get_source_hwid (void) const;
+			HWIDMASK get_destination_hwidmask (void) const;
+			bool is_for_destination (const HWID hwid) const;
+			bool is_for_destination (const HWID_LIST &lst) const;
+
+			/* Type */
+			std::string get_type (void) const;
+			uint32_t get_num_type (void) const;
+
+			/* Priority, trustlevel and TTL */
+			Chunk::Priority get_prio (void) const;
+			Chunk::TrustLevel get_trustlevel (void) const;
+			bool check_maximal_trustlevel (const Chunk::TrustLevel trust) const;
+			uint8_t get_ttl (void) const;
+			bool is_zero_ttl (void) const;
+
+			/* Tracert */
+			size_t tracert_hops_count (void) const;
+			Chunk::TRACERT_HOP tracert_hop (const size_t pos) const;
+
+			/* Payload */
+			bool has_payload (void) const;
+			SHAGA_STRV std::string_view get_payload (void) const;
+
+			/* CBOR and JSON, JSON is decoded on every call */
+			bool has_cbor (void) const;
+			SHAGA_STRV std::string_view get_cbor (void) const;
+			CBOR::Reader get_cbor_reader (void) const;
+			nlohmann::json get_json (void) const;
+
+			/* Meta. get_meta () decodes all entries, get_meta_value () only searches the binary data. */
+			bool has_meta (void) const;
+			SHAGA_STRV std::string_view get_meta_binary (void) const;
+			ChunkMeta get_meta (void) const;
+			SHAGA_STRV std::optional<std::string_view> get_meta_value (const uint16_t key) const;
+			SHAGA_STRV std::optional<std::string_view> get_meta_value (const std::string_view key) const;
+
+			/* Decode full Chunk */
+			Chunk to_chunk (const bool store_binary_representation = false) const;
+
+			/* Forward chunk on transit node without decoding payload, CBOR or meta. Chunk at offset is validated and
+			 * skipped the same way as by constructor, then its TTL is decremented and, if hwid_source is set, source
+			 * HWID is overwritten directly in bin. Returns the forwarded bytes, or empty string_view if TTL was
+			 * already zero, in which case the chunk is skipped and left untouched. */
+			SHAGA_STRV static std::string_view forward (std::string &bin, size_t &offset, const std::optional<HWID> hwid_source, const Chunk::SPECIAL_TYPES *const special_types = nullptr);
+	};
+
+	typedef std::vector<ChunkView> CHUNKVIEWS;
+
+	/* All chunks of one received buffer. Buffer is stored in one arena string and chunks are views into it, so
+	 * decoding a batch needs at most two allocations and the whole batch is freed in one step. When the same
+	 * ChunkBatch is reused, capacity is kept and steady state decoding doesn't allocate at all. */
+	class ChunkBatch {
+		private:
+			std::string _arena;
+			CHUNKVIEWS _views;
+
+			void _decode (const Chunk::SPECIAL_TYPES *const special_types);
+
+		public:
+			ChunkBatch () = default;
+
+			/* Replace content of the batch. On error, batch is empty. */
+			void decode (const std::string_view buf, const Chunk::SPECIAL_TYPES *const special_types = nullptr);
+			void decode (std::string &&buf, const Chunk::SPECIAL_TYPES *const special_types = nullptr);
+
+			/* Drop all chunks, keep allocated memory */
+			void clear (void);
+			/* Drop all chunks and release memory */
+			void reset (void);
+
+			size_t size (void) const;
+			bool empty (void) const;
+
+			CHUNKVIEWS::const_iterator begin (void) const;
+			CHUNKVIEWS::const_iterator end (void) const;
+			const ChunkView & operator[] (const size_t pos) const;
+
+			SHAGA_STRV std::string_view get_binary (void) const;
+
+			/* Views point into the arena, so batch can't be copied or moved */
+			ChunkBatch (const ChunkBatch &) = delete;
+			ChunkBatch (ChunkBatch &&) = delete;
+			ChunkBatch& operator= (const ChunkBatch &) = delete;
+			ChunkBatch& operator= (ChunkBatch &&) = delete;
+	};
+}
+
+#endif // HEAD_shaga_ChunkView
@@ -0,0 +1,388 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#ifndef HEAD_shaga_CoSPSC
+#define HEAD_shaga_CoSPSC
+
+#include "common.h"
+
+/* C++20 coroutine adapters for DecodeSPSC and EncodeSPSC. Library itself is compiled as C++17, so everything here
+ * is header-only and available only when the application is compiled with coroutine support.
+ *
+ * CoScheduler waits on eventfd of every SPSC using one epoll descriptor, so one thread can serve many links:
+ *
+ *   CoTask reader (CoScheduler &sched, PacketDecodeSPSC<SPSCDataDynAlloc> &decoder)
+ *   {
+ *       while (true) {
+ *           std::string packet = co_await sched.next (decoder);
+ *           ...
+ *       }
+ *   }
+ *
+ *   sched.spawn (reader (sched, decoder));
+ *   sched.run ();
+ *
+ * Before SPSC of a closed link is destroyed, call sched.forget (decoder) to remove its eventfd from epoll.
+ */
+
+#if defined(OS_LINUX) && defined(SHAGA_COROUTINES)
+
+#include <sys/epoll.h>
+
+namespace shaga {
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  CoTask  /////////////////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	/* Coroutine started and owned by CoScheduler. Task doesn't run until it is spawned. */
+	class CoTask
+	{
+		public:
+			struct promise_type
+			{
+				std::exception_ptr exception;
+
+				CoTask get_return_object (void)
+				{
+					return CoTask (std::coroutine_handle<promise_type>::from_promise (*this));
+				}
+
+				std::suspend_always initial_suspend (void) noexcept { return {}; }
+				std::suspend_always final_suspend (void) noexcept { return {}; }
+
+				void return_void (void) noexcept { }
+
+				void unhandled_exception (void) noexcept
+				{
+					exception = std::current_exception ();
+				}
+			};
+
+		private:
+			std::coroutine_handle<promise_type> _handle;
+
+			explicit CoTask (std::coroutine_handle<promise_type> handle) : _handle (handle) { }
+
+		public:
+			CoTask (CoTask &&other) noexcept : _handle (std::exchange (other._handle, nullptr)) { }
+
+			~CoTask ()
+			{
+				if (_handle) {
+					_handle.destroy ();
+				}
+			}
+
+			std::coroutine_handle<promise_type> release (void)
+			{
+				return std::exchange (_handle, nullptr);
+			}
+
+			CoTask (const CoTask &) = delete;
+			CoTask& operator= (const CoTask &) = delete;
+			CoTask& operator= (CoTask &&) = delete;
+	};
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  CoScheduler  ////////////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	class CoScheduler
+	{
+		public:
+			/* Base of all awaitables. Coroutine is suspended only if _try () fails, then it waits until fd is readable. */
+			class Awaiter
+			{
+				friend class CoScheduler;
+
+				private:
+					CoScheduler &_sched;
+					const int _fd;
+					std::coroutine_handle<> _handle;
+					std::exception_ptr _eptr;
+
+				protected:
+					virtual bool _try (void) = 0;
+
+					/* Failure of _try () inside scheduler is delivered to the waiting coroutine */
+					void _rethrow (void)
+					{
+						if (nullptr != _eptr) {
+							std::rethrow_exception (std::exchange (_eptr, nullptr));
+						}
+					}
+
+				public:
+					Awaiter (CoScheduler &sched, const int fd) : _sched (sched), _fd (fd) { }
+					virtual ~Awaiter () = default;
+
+					bool await_ready (void)
+					{
+						return _try ();
+					}
+
+					void await_suspend (std::coroutine_handle<> handle)
+					{
+						_handle = handle;
+						_sched._wait (this);
+					}
+			};
+
+			template<class T>
+			class NextAwaiter : public Awaiter
+			{
+				private:
+					DecodeSPSC<T> &_decoder;
+					std::string _out;
+
+				protected:
+					virtual bool _try (void) override final
+					{
+						return _decoder.pop_buffer (_out);
+					}
+
+				public:
+					NextAwaiter (CoScheduler &sched, DecodeSPSC<T> &decoder) : Awaiter (sched, decoder.get_eventfd ()), _decoder (decoder) { }
+
+					std::string await_resume (void)
+					{
+						this->_rethrow ();
+						return std::move (_out);
+					}
+			};
+
+			template<class T>
+			class WritableAwaiter : public Awaiter
+			{
+				private:
+					EncodeSPSC<T> &_encoder;
+
+				protected:
+					virtual bool _try (void) override final
+					{
+						/* Eventfd of encoder is a counter, reset it first, so no push can be missed */
+						uint64_t val;
+						if (::read (_encoder.get_eventfd (), &val, sizeof (val)) < 0 && EWOULDBLOCK != errno) {
+							cThrow ("Error reading from encoder eventfd: {}"sv, strerror (errno));
+						}
+						return (_encoder.empty () == false);
+					}
+
+				public:
+					WritableAwaiter (CoScheduler &sched, EncodeSPSC<T> &encoder) : Awaiter (sched, encoder.get_eventfd ()), _encoder (encoder) { }
+
+					void await_resume (void)
+					{
+						this->_rethrow ();
+					}
+			};
+
+		private:
+			static const constexpr int _max_events {64};
+
+			UNIQUE_SOCKET _epoll_sock;
+			std::unordered_map<int, Awaiter *> _waiters;
+			/* Descriptors already added to epoll, one shot only disarms them */
+			std::unordered_set<int> _registered;
+			std::unordered_map<void *, std::coroutine_handle<CoTask::promise_type>> _tasks;
+
+			void _wait (Awaiter *const awaiter)
+			{
+				if (_waiters.emplace (awaiter->_fd, awaiter).second == false) {
+					cThrow ("Another coroutine already waits on descriptor {}"sv, awaiter->_fd);
+				}
+
+				/* One shot, so descriptor is reported only while somebody waits on it */
+				try {
+					if (_registered.count (awaiter->_fd) == 0) {
+						LINUX::add_to_epoll (awaiter->_fd, EPOLLIN | EPOLLONESHOT, _epoll_sock->get ());
+						_registered.insert (awaiter->_fd);
+					}
+					else {
+						try {
+							LINUX::modify_epoll (awaiter->_fd, EPOLLIN | EPOLLONESHOT, _epoll_sock->get ());
+						}
+						catch (...) {
+							/* Descriptor was closed without forget () and its number was reused, epoll already dropped it */
+							LINUX::add_to_epoll (awaiter->_fd, EPOLLIN | EPOLLONESHOT, _epoll_sock->get ());
+						}
+					}
+				}
+				catch (...) {
+					_waiters.erase (awaiter->_fd);
+					throw;
+				}
+			}
+
+			void _forget (const int fd)
+			{
+				if (_waiters.count (fd) > 0) {
+					cThrow ("Coroutine still waits on descriptor {}"sv, fd);
+				}
+
+				if (_registered.erase (fd) > 0) {
+					LINUX::remove_from_epoll (fd, _epoll_sock->get (), true);
+				}
+			}
+
+			void _resume (std::coroutine_handle<> handle)
+			{
+				handle.resume ();
+
+				if (handle.done () == false) {
+					return;
+				}
+
+				/* Awaiters are only used directly from tasks, so finished handle is always a task */
+				auto iter = _tasks.find (handle.address ());
+				if (iter == _tasks.end ()) {
+					return;
+				}
+
+				std::exception_ptr eptr = std::move (iter->second.promise ().exception);
+				iter->second.destroy ();
+				_tasks.erase (iter);
+
+				if (nullptr != eptr) {
+					std::rethrow_exception (eptr);
+				}
+			}
+
+		public:
+			CoScheduler ()
+			{
+				const int fd = ::epoll_create1 (EPOLL_CLOEXEC);
+				if (fd < 0) {
+					cThrow ("Unable to create epoll: {}"sv, strerror (errno));
+				}
+				_epoll_sock = std::make_unique<ShSocket> (fd);
+			}
+
+			~CoScheduler ()
+			{
+				for (auto &[addr, handle] : _tasks) {
+					handle.destroy ();
+				}
+			}
+
+			CoScheduler (const CoScheduler &) = delete;
+			CoScheduler& operator= (const CoScheduler &) = delete;
+
+			/* Take ownership of the task and run it until its first suspension */
+			void spawn (CoTask &&task)
+			{
+				auto handle = task.release ();
+				_tasks.emplace (handle.address (), handle);
+				_resume (handle);
+			}
+
+			/* co_await sched.next (decoder) returns next decoded buffer */
+			template<class T>
+			NextAwaiter<T> next (DecodeSPSC<T> &decoder)
+			{
+				return NextAwaiter<T> (*this, decoder);
+			}
+
+			/* co_await sched.writable (encoder) returns when encoder has data ready to be written out */
+			template<class T>
+			WritableAwaiter<T> writable (EncodeSPSC<T> &encoder)
+			{
+				return WritableAwaiter<T> (*this, encoder);
+			}
+
+			/* Stop watching SPSC before it is destroyed, so descriptor number reused by another link starts clean.
+			 * No coroutine may wait on it. */
+			template<class T>
+			void forget (DecodeSPSC<T> &decoder)
+			{
+				_forget (decoder.get_eventfd ());
+			}
+
+			template<class T>
+			void forget (EncodeSPSC<T> &encoder)
+			{
+				_forget (encoder.get_eventfd ());
+			}
+
+			/* Wait up to timeout_ms (-1 = infinite) and resume all coroutines that can continue.
+			 * Exception thrown from a task is rethrown here, after the task is destroyed.
+			 * Returns number of resumed coroutines. */
+			size_t run_once (const int timeout_ms)
+			{
+				struct epoll_event events[_max_events];
+
+				const int ret = ::epoll_wait (_epoll_sock->get (), events, _max_events, timeout_ms);
+				if (ret < 0) {
+					if (EINTR == errno) {
+						return 0;
+					}
+					cThrow ("Error waiting for epoll: {}"sv, strerror (errno));
+				}
+
+				size_t resumed {0};
+				std::exception_ptr eptr;
+
+				for (int i = 0; i < ret; ++i) {
+					auto iter = _waiters.find (events[i].data.fd);
+					if (iter == _waiters.end ()) {
+						continue;
+					}
+
+					Awaiter *const awaiter = iter->second;
+					_waiters.erase (iter);
+
+					bool ready;
+					try {
+						ready = awaiter->_try ();
+					}
+					catch (...) {
+						awaiter->_eptr = std::current_exception ();
+						ready = true;
+					}
+
+					if (false == ready) {
+						/* Spurious wake up, wait again */
+						_wait (awaiter);
+						continue;
+					}
+
+					++resumed;
+					try {
+						_resume (awaiter->_handle);
+					}
+					catch (...) {
+						/* Other events must be processed, or their coroutines would never wake up */
+						if (nullptr == eptr) {
+							eptr = std::current_exception ();
+						}
+					}
+				}
+
+				if (nullptr != eptr) {
+					std::rethrow_exception (eptr);
+				}
+
+				return resumed;
+			}
+
+			/* Run until all tasks are finished */
+			void run (void)
+			{
+				while (_tasks.empty () == false) {
+					run_once (-1);
+				}
+			}
+
+			size_t get_task_count (void) const
+			{
+				return _tasks.size ();
+			}
+	};
+}
+
+#endif // OS_LINUX && SHAGA_COROUTINES
+#endif // HEAD_shaga_CoSPSC
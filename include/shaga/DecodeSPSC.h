@@ -42,6 +42,23 @@ namespace shaga
 				uint64_t _eventfd_read_val {0};
 			#endif // OS_LINUX
 
+			std::unique_ptr<LZ::Decompressor> _decompressor;
+			std::string _peek_buf;
+			bool _peek_valid {false};
+
+			void _decompress (const uint_fast32_t now, std::string &out)
+			{
+				out.resize (0);
+
+				try {
+					_decompressor->decompress (std::string_view (reinterpret_cast<const char *> (this->_data[now]->buffer), this->_data[now]->size ()), out);
+				}
+				catch (const std::exception &e) {
+					/* Dictionary is no longer in sync with the other side */
+					cThrow ("{}: Decompression failed: {}"sv, this->_name, e.what ());
+				}
+			}
+
 		protected:
 			const uint_fast32_t _max_packet_size;
 			const uint_fast32_t _num_packets;
@@ -79,7 +96,7 @@ namespace shaga
 			virtual void nonfatal_error (const std::string_view buf) final
 			{
 				#ifdef SHAGA_THREADING
-					_err_count.fetch_add (1, std::memory_order::memory_order_relaxed);
+					_err_count.fetch_add (1, std::memory_order_relaxed);
 				#else
 					++_err_count;
 				#endif // SHAGA_THREADING
@@ -193,7 +210,7 @@ namespace shaga
 			virtual uint_fast32_t get_err_count (void) const final
 			{
 				#ifdef SHAGA_THREADING
-					return _err_count.load (std::memory_order::memory_order_relaxed);
+					return _err_count.load (std::memory_order_relaxed);
 				#else
 					return _err_count;
 				#endif // SHAGA_THREADING
@@ -202,7 +219,7 @@ namespace shaga
 			virtual uint_fast32_t get_err_count_reset (void) final
 			{
 				#ifdef SHAGA_THREADING
-					return _err_count.exchange (0, std::memory_order::memory_order_acq_rel);
+					return _err_count.exchange (0, std::memory_order_acq_rel);
 				#else
 					return std::exchange (_err_count, 0);
 				#endif // SHAGA_THREADING
@@ -246,7 +263,24 @@ namespace shaga
 					}
 				#endif // SHAGA_THREADING
 
-				out.assign (reinterpret_cast<const char *> (this->_data[now]->buffer), this->_data[now]->size ());
+				std::exception_ptr eptr;
+
+				if (nullptr == _decompressor) {
+					out.assign (reinterpret_cast<const char *> (this->_data[now]->buffer), this->_data[now]->size ());
+				}
+				else if (true == _peek_valid) {
+					out.swap (_peek_buf);
+					_peek_valid = false;
+				}
+				else {
+					try {
+						_decompress (now, out);
+					}
+					catch (...) {
+						eptr = std::current_exception ();
+					}
+				}
+
 				this->_data[now]->free ();
 
 				_SHAGA_SPSC_D_RING (next, now);
@@ -257,6 +291,10 @@ namespace shaga
 					this->_pos_read = next;
 				#endif // SHAGA_THREADING
 
+				if (nullptr != eptr) {
+					std::rethrow_exception (eptr);
+				}
+
 				return true;
 			}
 
@@ -286,6 +324,21 @@ namespace shaga
 					}
 				#endif // SHAGA_THREADING
 
+				std::exception_ptr eptr;
+
+				if (nullptr != _decompressor) {
+					/* Even discarded data has to go through decompressor to keep dictionary in sync */
+					if (false == _peek_valid) {
+						try {
+							_decompress (now, _peek_buf);
+						}
+						catch (...) {
+							eptr = std::current_exception ();
+						}
+					}
+					_peek_valid = false;
+				}
+
 				this->_data[now]->free ();
 
 				_SHAGA_SPSC_D_RING (next, now);
@@ -296,6 +349,10 @@ namespace shaga
 					this->_pos_read = next;
 				#endif // SHAGA_THREADING
 
+				if (nullptr != eptr) {
+					std::rethrow_exception (eptr);
+				}
+
 				return true;
 			}
 
@@ -313,9 +370,31 @@ namespace shaga
 					}
 				#endif // SHAGA_THREADING
 
+				if (nullptr != _decompressor) {
+					/* Decompressed data are kept until pop_buffer is called */
+					if (false == _peek_valid) {
+						_decompress (now, _peek_buf);
+						_peek_valid = true;
+					}
+					return std::optional<std::string_view> {std::in_place, _peek_buf};
+				}
+
 				return std::optional<std::string_view> {std::in_place, reinterpret_cast<const char *> (this->_data[now]->buffer), this->_data[now]->size ()};
 			}
 
+			/* Decompress every popped buffer using LZ::Decompressor. Must match settings of EncodeSPSC on the other side.
+			 * If decompression fails, buffer is dropped and exception is thrown. Link should be then re-established. */
+			virtual void set_compression (const bool enabled, const bool use_dictionary = true) final
+			{
+				if (true == enabled) {
+					_decompressor = std::make_unique<LZ::Decompressor> (use_dictionary);
+				}
+				else {
+					_decompressor.reset ();
+				}
+				_peek_valid = false;
+			}
+
 			virtual void push_buffer (const void *const buffer, const uint_fast32_t offset, const uint_fast32_t len) final
 			{
 				this->_push_buffer (reinterpret_cast<const uint8_t *> (buffer), offset, len);
@@ -525,7 +604,7 @@ namespace shaga
 						}
 						else {
 							#ifdef SHAGA_THREADING
-								_ignored_bytes.fetch_add (1, std::memory_order::memory_order_relaxed);
+								_ignored_bytes.fetch_add (1, std::memory_order_relaxed);
 							#else
 								_ignored_bytes += 1;
 							#endif // SHAGA_THREADING
@@ -539,7 +618,7 @@ namespace shaga
 							/* Expected second STX character, return to the beginning */
 							_got_stx = 0;
 							#ifdef SHAGA_THREADING
-								_ignored_bytes.fetch_add (2, std::memory_order::memory_order_relaxed);
+								_ignored_bytes.fetch_add (2, std::memory_order_relaxed);
 							#else
 								_ignored_bytes += 2;
 							#endif // SHAGA_THREADING
@@ -563,7 +642,7 @@ namespace shaga
 							_remaining_len = UINT32_MAX;
 
 							#ifdef SHAGA_THREADING
-								_ignored_bytes.fetch_add (4, std::memory_order::memory_order_relaxed);
+								_ignored_bytes.fetch_add (4, std::memory_order_relaxed);
 							#else
 								_ignored_bytes += 4;
 							#endif // SHAGA_THREADING
@@ -626,7 +705,7 @@ namespace shaga
 			virtual uint_fast32_t get_ignored_bytes (void) const
 			{
 				#ifdef SHAGA_THREADING
-					return _ignored_bytes.load (std::memory_order::memory_order_relaxed);
+					return _ignored_bytes.load (std::memory_order_relaxed);
 				#else
 					return _ignored_bytes;
 				#endif // SHAGA_THREADING
@@ -635,7 +714,7 @@ namespace shaga
 			virtual uint_fast32_t get_ignored_bytes_reset (void)
 			{
 				#ifdef SHAGA_THREADING
-					return _ignored_bytes.exchange (0, std::memory_order::memory_order_acq_rel);
+					return _ignored_bytes.exchange (0, std::memory_order_acq_rel);
 				#else
 					return std::exchange (_ignored_bytes, 0);
 				#endif // SHAGA_THREADING
@@ -793,6 +872,125 @@ namespace shaga
 				DecodeSPSC<T> (max_packet_size, num_packets)
 			{ }
 	};
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  VarPacketDecodeSPSC  ////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	template<class T> class VarPacketDecodeSPSC : public DecodeSPSC<T>
+	{
+		private:
+			static const constexpr size_t _crc_size {sizeof (uint32_t)};
+
+			bool _has_crc32c {false};
+			bool _skip_data {false};
+
+			uint_fast32_t _size_len {0};
+			uint_fast32_t _remaining_data {0};
+			uint_fast32_t _remaining_crc {0};
+
+			std::string _size_buf;
+			std::string _crc_buf;
+
+			virtual void _push_buffer (const uint8_t *const buffer, uint_fast32_t offset, const uint_fast32_t len) override final
+			{
+				while (offset < len) {
+					if (_remaining_data > 0) {
+						/* Copy as much of the data as is available in one go */
+						const uint_fast32_t cnt = std::min (_remaining_data, len - offset);
+
+						if (false == _skip_data) {
+							::memcpy (this->_curdata->buffer + this->_curdata->size (), buffer + offset, cnt);
+							this->_curdata->set_size (this->_curdata->size () + cnt);
+						}
+
+						offset += cnt;
+						_remaining_data -= cnt;
+
+						if (0 == _remaining_data && 0 == _remaining_crc && false == _skip_data) {
+							this->push ();
+						}
+					}
+					else if (_remaining_crc > 0) {
+						_crc_buf.push_back (static_cast<char> (buffer[offset]));
+						++offset;
+						--_remaining_crc;
+
+						if (0 == _remaining_crc && false == _skip_data) {
+							if (BIN::to_uint32 (_crc_buf) != CRC::crc32c (this->_curdata->buffer, this->_curdata->size ())) {
+								this->nonfatal_error ("CRC-32C mismatch"sv);
+							}
+							else {
+								this->push ();
+							}
+						}
+					}
+					else {
+						if (0 == _size_len) {
+							/* First byte of size tells how many bytes are used, see BIN::to_size */
+							if ((buffer[offset] & 0x80) == 0) {
+								_size_len = 1;
+							}
+							else if ((buffer[offset] & 0xC0) == 0x80) {
+								_size_len = 2;
+							}
+							else if ((buffer[offset] & 0xE0) == 0xC0) {
+								_size_len = 3;
+							}
+							else if ((buffer[offset] & 0xF0) == 0xE0) {
+								_size_len = 4;
+							}
+							else {
+								++offset;
+								this->nonfatal_error ("Malformed size"sv);
+								continue;
+							}
+							_size_buf.resize (0);
+						}
+
+						_size_buf.push_back (static_cast<char> (buffer[offset]));
+						++offset;
+
+						if (_size_buf.size () < _size_len) {
+							continue;
+						}
+
+						const size_t sze = BIN::to_size (_size_buf);
+
+						_size_len = 0;
+						_skip_data = false;
+						_remaining_data = sze;
+						_remaining_crc = _has_crc32c ? _crc_size : 0;
+						_crc_buf.resize (0);
+
+						if (0 == sze) {
+							_remaining_crc = 0;
+							this->nonfatal_error ("Zero length packet"sv);
+						}
+						else if (sze > this->_max_packet_size) {
+							_skip_data = true;
+							this->nonfatal_error ("Packet size larger than allocated size, skipping..."sv);
+						}
+						else {
+							this->_curdata->alloc (sze);
+							this->_curdata->zero_size ();
+						}
+					}
+				}
+			}
+
+		public:
+			VarPacketDecodeSPSC (const uint_fast32_t max_packet_size, const uint_fast32_t num_packets) :
+				DecodeSPSC<T> (max_packet_size, num_packets)
+			{
+				_size_buf.reserve (4);
+				_crc_buf.reserve (_crc_size);
+			}
+
+			virtual void has_crc32c (const bool enabled) final
+			{
+				_has_crc32c = enabled;
+			}
+	};
 }
 
 #endif // HEAD_shaga_DecodeSPSC
@@ -27,6 +27,95 @@ namespace shaga
 				uint64_t _eventfd_read_val {0};
 			#endif // OS_LINUX
 
+			std::unique_ptr<LZ::Compressor> _compressor;
+			std::string _compress_buf;
+			std::string _direct_buf;
+			std::string _direct_chunk_buf;
+
+			void _compress_and_push (const uint8_t *const buffer, const uint_fast32_t offset, const uint_fast32_t len)
+			{
+				if (nullptr == _compressor || offset >= len) {
+					this->_push_buffer (buffer, offset, len);
+					return;
+				}
+
+				_compress_buf.resize (0);
+				_compressor->compress (std::string_view (reinterpret_cast<const char *> (buffer + offset), len - offset), _compress_buf);
+
+				try {
+					this->_push_buffer (reinterpret_cast<const uint8_t *> (_compress_buf.data ()), 0, _compress_buf.size ());
+				}
+				catch (...) {
+					/* Frame was not stored, so the other side will never see it */
+					_compressor->rollback ();
+					throw;
+				}
+			}
+
+			/* Serialize chunks from range into out, as long as they fit into capacity. Chunks are written directly,
+			 * only the one crossing the estimated end is serialized into temporary buffer to find its real size.
+			 * Returns iterator after the last written chunk. */
+			template<class Iter>
+			Iter _serialize_chunks (Iter first, const Iter last, char *const out, size_t &offset, const size_t capacity, const Chunk::SPECIAL_TYPES *const special_types)
+			{
+				for (; first != last; ++first) {
+					if ((offset + first->get_max_bytes ()) <= capacity) {
+						first->to_bin (out, offset, special_types);
+						continue;
+					}
+
+					_direct_chunk_buf.resize (0);
+					first->to_bin (_direct_chunk_buf, special_types);
+					if ((offset + _direct_chunk_buf.size ()) > capacity) {
+						break;
+					}
+
+					::memcpy (out + offset, _direct_chunk_buf.data (), _direct_chunk_buf.size ());
+					offset += _direct_chunk_buf.size ();
+				}
+
+				return first;
+			}
+
+			template<class Iter>
+			Iter _push_chunks (const Iter first, const Iter last, const Chunk::SPECIAL_TYPES *const special_types)
+			{
+				uint_fast32_t capacity = this->_direct_capacity ();
+				if (0 == capacity) {
+					cThrow ("{}: Direct serialization is not supported"sv, _name);
+				}
+
+				if (first == last) {
+					return first;
+				}
+
+				size_t offset {0};
+				Iter iter;
+
+				if (nullptr == _compressor) {
+					iter = _serialize_chunks (first, last, reinterpret_cast<char *> (this->_direct_begin ()), offset, capacity, special_types);
+				}
+				else {
+					/* Compressed frame can be one byte longer than data */
+					--capacity;
+					_direct_buf.resize (capacity);
+					iter = _serialize_chunks (first, last, _direct_buf.data (), offset, capacity, special_types);
+				}
+
+				if (iter == first) {
+					cThrow ("{}: Chunk is larger than packet"sv, _name);
+				}
+
+				if (nullptr == _compressor) {
+					this->_direct_commit (offset);
+				}
+				else {
+					this->_compress_and_push (reinterpret_cast<const uint8_t *> (_direct_buf.data ()), 0, offset);
+				}
+
+				return iter;
+			}
+
 		protected:
 			const uint_fast32_t _max_packet_size;
 			const uint_fast32_t _num_packets;
@@ -64,14 +153,14 @@ namespace shaga
 			virtual void push (void) final
 			{
 				#ifdef SHAGA_THREADING
-					_SHAGA_SPSC_D_RING (next, _pos_write.load (std::memory_order::memory_order_relaxed));
+					_SHAGA_SPSC_D_RING (next, _pos_write.load (std::memory_order_relaxed));
 
-					if (next == _pos_read.load (std::memory_order::memory_order_acquire)) {
+					if (next == _pos_read.load (std::memory_order_acquire)) {
 						cThrow ("{}: Ring full"sv, _name);
 					}
 
-					_pos_write.store (next, std::memory_order::memory_order_relaxed);
-					_stored_bytes.fetch_add (_curdata->size (), std::memory_order::memory_order_seq_cst);
+					_pos_write.store (next, std::memory_order_relaxed);
+					_stored_bytes.fetch_add (_curdata->size (), std::memory_order_seq_cst);
 				#else
 					_SHAGA_SPSC_D_RING (next, _pos_write);
 
@@ -97,6 +186,25 @@ namespace shaga
 
 			virtual void _push_buffer (const uint8_t *const buffer, uint_fast32_t offset, const uint_fast32_t len) = 0;
 
+			/* Encoders able to write data directly into current slot return maximal size of data in one packet,
+			 * _direct_begin () prepares the slot and returns pointer where data belong and _direct_commit ()
+			 * finishes and pushes the packet with given size of data. */
+			virtual uint_fast32_t _direct_capacity (void) const
+			{
+				return 0;
+			}
+
+			virtual uint8_t * _direct_begin (void)
+			{
+				cThrow ("{}: Direct serialization is not supported"sv, _name);
+			}
+
+			virtual void _direct_commit (const uint_fast32_t len)
+			{
+				(void) len;
+				cThrow ("{}: Direct serialization is not supported"sv, _name);
+			}
+
 		public:
 			EncodeSPSC (const uint_fast32_t max_packet_size, const uint_fast32_t num_packets) :
 				_max_packet_size (max_packet_size),
@@ -187,19 +295,51 @@ namespace shaga
 
 			virtual void move_front_buffer (uint_fast32_t len) = 0;
 
+			/* Compress every pushed buffer using LZ::Compressor. Frame can be one byte longer than original buffer,
+			 * so max_packet_size should account for it. DecodeSPSC on the other side must have compression enabled. */
+			virtual void set_compression (const bool enabled, const bool use_dictionary = true) final
+			{
+				if (true == enabled) {
+					_compressor = std::make_unique<LZ::Compressor> (use_dictionary);
+				}
+				else {
+					_compressor.reset ();
+				}
+			}
+
 			virtual void push_buffer (const void *const buffer, const uint_fast32_t offset, const uint_fast32_t len) final
 			{
-				this->_push_buffer (reinterpret_cast<const uint8_t *> (buffer), offset, len);
+				this->_compress_and_push (reinterpret_cast<const uint8_t *> (buffer), offset, len);
 			}
 
 			virtual void push_buffer (const void *const buffer, const uint_fast32_t len) final
 			{
-				this->_push_buffer (reinterpret_cast<const uint8_t *> (buffer), 0, len);
+				this->_compress_and_push (reinterpret_cast<const uint8_t *> (buffer), 0, len);
 			}
 
 			virtual void push_buffer (const std::string_view buffer) final
 			{
-				this->_push_buffer (reinterpret_cast<const uint8_t *> (buffer.data ()), 0, buffer.size ());
+				this->_compress_and_push (reinterpret_cast<const uint8_t *> (buffer.data ()), 0, buffer.size ());
+			}
+
+			/* Serialize chunk directly into one packet, without intermediate buffer.
+			 * Supported by PacketEncodeSPSC and SeqPacketEncodeSPSC. */
+			void push_chunk (const Chunk &chunk, const Chunk::SPECIAL_TYPES *const special_types = nullptr)
+			{
+				this->_push_chunks (&chunk, &chunk + 1, special_types);
+			}
+
+			/* Serialize as many chunks from the beginning of container (e.g. CHUNKLIST or CHUNKSET) as fit into one packet.
+			 * Chunks that were pushed are erased from the container, the rest is left there for the next call.
+			 * Returns number of pushed chunks. Supported by PacketEncodeSPSC and SeqPacketEncodeSPSC. */
+			template<class C>
+			size_t push_chunks (C &lst_erase, const Chunk::SPECIAL_TYPES *const special_types = nullptr)
+			{
+				const auto iter = this->_push_chunks (lst_erase.begin (), lst_erase.end (), special_types);
+				const size_t cnt = static_cast<size_t> (std::distance (lst_erase.begin (), iter));
+
+				lst_erase.erase (lst_erase.begin (), iter);
+				return cnt;
 			}
 	};
 
@@ -234,8 +374,8 @@ namespace shaga
 
 				_read_offset = 0;
 				#ifdef SHAGA_THREADING
-					this->_pos_read.store (now_read, std::memory_order::memory_order_relaxed);
-					this->_stored_bytes.store (0, std::memory_order::memory_order_release);
+					this->_pos_read.store (now_read, std::memory_order_relaxed);
+					this->_stored_bytes.store (0, std::memory_order_release);
 				#else
 					this->_pos_read = now_read;
 					this->_stored_bytes = 0;
@@ -399,8 +539,8 @@ namespace shaga
 
 				_read_offset = read_offset;
 				#ifdef SHAGA_THREADING
-					this->_pos_read.store (now_read, std::memory_order::memory_order_relaxed);
-					this->_stored_bytes.fetch_sub (orig_len, std::memory_order::memory_order_seq_cst);
+					this->_pos_read.store (now_read, std::memory_order_relaxed);
+					this->_stored_bytes.fetch_sub (orig_len, std::memory_order_seq_cst);
 				#else
 					this->_pos_read = now_read;
 					this->_stored_bytes -= orig_len;
@@ -435,8 +575,8 @@ namespace shaga
 				}
 
 				#ifdef SHAGA_THREADING
-					this->_pos_read.store (now_read, std::memory_order::memory_order_relaxed);
-					this->_stored_bytes.store (0, std::memory_order::memory_order_release);
+					this->_pos_read.store (now_read, std::memory_order_relaxed);
+					this->_stored_bytes.store (0, std::memory_order_release);
 				#else
 					this->_pos_read = now_read;
 					this->_stored_bytes = 0;
@@ -454,8 +594,8 @@ namespace shaga
 				}
 
 				#ifdef SHAGA_THREADING
-					uint_fast32_t now_read = this->_pos_read.load (std::memory_order::memory_order_relaxed);
-					const uint_fast32_t now_write = this->_pos_write.load (std::memory_order::memory_order_acquire);
+					uint_fast32_t now_read = this->_pos_read.load (std::memory_order_relaxed);
+					const uint_fast32_t now_write = this->_pos_write.load (std::memory_order_acquire);
 				#else
 					uint_fast32_t now_read = this->_pos_read;
 					const uint_fast32_t now_write = this->_pos_write;
@@ -517,8 +657,8 @@ namespace shaga
 				}
 
 				#ifdef SHAGA_THREADING
-					uint_fast32_t now_read = this->_pos_read.load (std::memory_order::memory_order_relaxed);
-					const uint_fast32_t now_write = this->_pos_write.load (std::memory_order::memory_order_acquire);
+					uint_fast32_t now_read = this->_pos_read.load (std::memory_order_relaxed);
+					const uint_fast32_t now_write = this->_pos_write.load (std::memory_order_acquire);
 				#else
 					uint_fast32_t now_read = this->_pos_read;
 					const uint_fast32_t now_write = this->_pos_write;
@@ -536,8 +676,8 @@ namespace shaga
 				_SHAGA_SPSC_I_RING (now_read);
 
 				#ifdef SHAGA_THREADING
-					this->_pos_read.store (now_read, std::memory_order::memory_order_relaxed);
-					this->_stored_bytes.fetch_sub (len, std::memory_order::memory_order_seq_cst);
+					this->_pos_read.store (now_read, std::memory_order_relaxed);
+					this->_stored_bytes.fetch_sub (len, std::memory_order_seq_cst);
 				#else
 					this->_pos_read = now_read;
 					this->_stored_bytes -= len;
@@ -707,14 +847,9 @@ namespace shaga
 
 			std::string header;
 
-			virtual void _push_buffer (const uint8_t *const buffer, uint_fast32_t offset, const uint_fast32_t len) override final
+			/* Data of size sze are already stored after the header */
+			void _finish_packet (const uint_fast32_t sze)
 			{
-				const uint_fast32_t sze = len - offset;
-
-				if (0 == sze) {
-					return;
-				}
-
 				header.resize (0);
 				header.append (_magic, sizeof (_magic));
 
@@ -728,19 +863,46 @@ namespace shaga
 					cThrow ("Header has incorrect size"sv);
 				}
 
+				this->_curdata->set_size (sze + _header_size);
+				::memcpy (this->_curdata->buffer, header.data (), _header_size);
+
+				this->_curdata->buffer[2] = CRC::crc8_dallas (this->_curdata->buffer + 3, std::min (this->_curdata->size () - 3, _crc_max_len), _crc_start_val);
+
+				this->push ();
+			}
+
+			virtual void _push_buffer (const uint8_t *const buffer, uint_fast32_t offset, const uint_fast32_t len) override final
+			{
+				const uint_fast32_t sze = len - offset;
+
+				if (0 == sze) {
+					return;
+				}
+
 				if ((sze + _header_size) > this->_max_packet_size) {
 					cThrow ("Buffer too long"sv);
 				}
 
 				this->_curdata->alloc (sze + _header_size);
-				this->_curdata->set_size (sze + _header_size);
-
-				::memcpy (this->_curdata->buffer, header.data (), _header_size);
 				::memcpy (this->_curdata->buffer + _header_size, buffer + offset, sze);
 
-				this->_curdata->buffer[2] = CRC::crc8_dallas (this->_curdata->buffer + 3, std::min (this->_curdata->size () - 3, _crc_max_len), _crc_start_val);
+				_finish_packet (sze);
+			}
 
-				this->push ();
+			virtual uint_fast32_t _direct_capacity (void) const override final
+			{
+				return this->_max_packet_size - _header_size;
+			}
+
+			virtual uint8_t * _direct_begin (void) override final
+			{
+				this->_curdata->alloc (this->_max_packet_size);
+				return this->_curdata->buffer + _header_size;
+			}
+
+			virtual void _direct_commit (const uint_fast32_t len) override final
+			{
+				_finish_packet (len);
 			}
 
 		public:
@@ -762,14 +924,9 @@ namespace shaga
 			static const constexpr size_t _header_size {3};
 			std::string header;
 
-			virtual void _push_buffer (const uint8_t *const buffer, uint_fast32_t offset, const uint_fast32_t len) override final
+			/* Data of size sze are already stored after the header */
+			void _finish_packet (const uint_fast32_t sze)
 			{
-				const uint_fast32_t sze = len - offset;
-
-				if (0 == sze) {
-					return;
-				}
-
 				header.resize (0);
 				BIN::from_uint24 (sze, header);
 
@@ -777,17 +934,44 @@ namespace shaga
 					cThrow ("Header has incorrect size"sv);
 				}
 
+				this->_curdata->set_size (sze + _header_size);
+				::memcpy (this->_curdata->buffer, header.data (), _header_size);
+
+				this->push ();
+			}
+
+			virtual void _push_buffer (const uint8_t *const buffer, uint_fast32_t offset, const uint_fast32_t len) override final
+			{
+				const uint_fast32_t sze = len - offset;
+
+				if (0 == sze) {
+					return;
+				}
+
 				if ((sze + _header_size) > this->_max_packet_size) {
 					cThrow ("Buffer too long"sv);
 				}
 
 				this->_curdata->alloc (sze + _header_size);
-				this->_curdata->set_size (sze + _header_size);
-
-				::memcpy (this->_curdata->buffer, header.data (), _header_size);
 				::memcpy (this->_curdata->buffer + _header_size, buffer + offset, sze);
 
-				this->push ();
+				_finish_packet (sze);
+			}
+
+			virtual uint_fast32_t _direct_capacity (void) const override final
+			{
+				return this->_max_packet_size - _header_size;
+			}
+
+			virtual uint8_t * _direct_begin (void) override final
+			{
+				this->_curdata->alloc (this->_max_packet_size);
+				return this->_curdata->buffer + _header_size;
+			}
+
+			virtual void _direct_commit (const uint_fast32_t len) override final
+			{
+				_finish_packet (len);
 			}
 
 		public:
@@ -798,6 +982,73 @@ namespace shaga
 				header.reserve (_header_size);
 			}
 	};
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  VarPacketEncodeSPSC  ////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	/* Compact framing for reliable streams: size encoded using BIN::from_size (1 to 4 bytes) + data + optional CRC-32C
+	 * of data (little endian). There is no magic, so the receiver is not able to resynchronize after corrupted size. */
+	template<class T> class VarPacketEncodeSPSC : public ContStreamEncodeSPSC<T>
+	{
+		private:
+			static const constexpr size_t _max_header_size {4};
+			static const constexpr size_t _crc_size {sizeof (uint32_t)};
+
+			const uint_fast32_t _max_data_size;
+			bool _has_crc32c {false};
+
+			std::string header;
+
+			virtual void _push_buffer (const uint8_t *const buffer, uint_fast32_t offset, const uint_fast32_t len) override final
+			{
+				const uint_fast32_t sze = len - offset;
+
+				if (0 == sze) {
+					return;
+				}
+
+				if (sze > _max_data_size) {
+					cThrow ("Buffer too long"sv);
+				}
+
+				header.resize (0);
+				BIN::from_size (sze, header);
+
+				const size_t total_size = header.size () + sze + (_has_crc32c ? _crc_size : 0);
+
+				this->_curdata->alloc (total_size);
+				this->_curdata->set_size (total_size);
+
+				size_t pos {header.size ()};
+				::memcpy (this->_curdata->buffer, header.data (), pos);
+				::memcpy (this->_curdata->buffer + pos, buffer + offset, sze);
+				pos += sze;
+
+				if (true == _has_crc32c) {
+					BIN::_from_uint32 (CRC::crc32c (buffer + offset, sze), this->_curdata->buffer, pos);
+				}
+
+				this->push ();
+			}
+
+		public:
+			/* Result can have max_packet_size plus up to 4 bytes of size and 4 bytes of CRC-32C */
+			VarPacketEncodeSPSC (const uint_fast32_t max_packet_size, const uint_fast32_t num_packets) :
+				ContStreamEncodeSPSC<T> (max_packet_size + _max_header_size + _crc_size, num_packets),
+				_max_data_size (max_packet_size)
+			{
+				if (max_packet_size > 0xFFFFFFF) {
+					cThrow ("Maximal packet size cannot exceed {} bytes"sv, 0xFFFFFFF);
+				}
+
+				header.reserve (_max_header_size);
+			}
+
+			virtual void has_crc32c (const bool enabled) final
+			{
+				_has_crc32c = enabled;
+			}
+	};
 }
 
 #endif // HEAD_shaga_EncodeSPSC
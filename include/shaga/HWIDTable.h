@@ -0,0 +1,187 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#ifndef HEAD_shaga_HWIDTable
+#define HEAD_shaga_HWIDTable
+
+#include "common.h"
+
+namespace shaga
+{
+	/* Routing table keyed by HWIDMASK. Routes are grouped by mask and every group is a hash table of masked HWIDs,
+	 * groups are ordered from the longest mask (most bits set) to broadcast. Lookup costs one hash probe per distinct
+	 * mask instead of HWIDMASK::check against every route, and since real tables use only a handful of different
+	 * masks, it doesn't depend on number of routes. Masks don't have to be prefixes. */
+	template<class T>
+	class HWIDTable
+	{
+		private:
+			struct Group {
+				HWID mask;
+				size_t bits;
+				std::unordered_map<HWID, T> routes;
+			};
+
+			std::vector<Group> _groups;
+			size_t _size {0};
+
+			typename std::vector<Group>::iterator _find_group (const HWID mask)
+			{
+				return std::find_if (_groups.begin (), _groups.end (), [mask](const Group &g) -> bool { return g.mask == mask; });
+			}
+
+			typename std::vector<Group>::const_iterator _find_group (const HWID mask) const
+			{
+				return std::find_if (_groups.cbegin (), _groups.cend (), [mask](const Group &g) -> bool { return g.mask == mask; });
+			}
+
+			Group & _get_group (const HWID mask)
+			{
+				auto iter = _find_group (mask);
+				if (iter != _groups.end ()) {
+					return *iter;
+				}
+
+				/* Keep longest masks first. Masks with the same number of bits are ordered by value, so lookup order
+				 * doesn't depend on order of insertion. */
+				const size_t bits = BIN::count_ones (mask);
+				iter = std::find_if (_groups.begin (), _groups.end (), [bits, mask](const Group &g) -> bool {
+					return g.bits < bits || (g.bits == bits && g.mask < mask);
+				});
+				return *(_groups.insert (iter, Group {mask, bits, {}}));
+			}
+
+		public:
+			HWIDTable () = default;
+
+			/* Add route, existing route with the same HWIDMASK is kept. Returns true if route was added. */
+			bool insert (const HWIDMASK &hwidmask, const T &value)
+			{
+				Group &g = _get_group (hwidmask.mask);
+				if (g.routes.emplace (hwidmask.hwid & hwidmask.mask, value).second == false) {
+					return false;
+				}
+				++_size;
+				return true;
+			}
+
+			/* Add route or replace value of existing route */
+			void insert_or_assign (const HWIDMASK &hwidmask, const T &value)
+			{
+				Group &g = _get_group (hwidmask.mask);
+				if (g.routes.insert_or_assign (hwidmask.hwid & hwidmask.mask, value).second == true) {
+					++_size;
+				}
+			}
+
+			/* Remove route. Returns true if route existed. */
+			bool remove (const HWIDMASK &hwidmask)
+			{
+				auto iter = _find_group (hwidmask.mask);
+				if (iter == _groups.end () || iter->routes.erase (hwidmask.hwid & hwidmask.mask) == 0) {
+					return false;
+				}
+
+				--_size;
+				if (iter->routes.empty () == true) {
+					_groups.erase (iter);
+				}
+				return true;
+			}
+
+			/* Exact route lookup */
+			const T * find (const HWIDMASK &hwidmask) const
+			{
+				auto iter = _find_group (hwidmask.mask);
+				if (iter == _groups.cend ()) {
+					return nullptr;
+				}
+
+				auto found = iter->routes.find (hwidmask.hwid & hwidmask.mask);
+				return (found == iter->routes.cend ()) ? nullptr : &(found->second);
+			}
+
+			/* Route with the longest mask matching hwid, nullptr if none */
+			const T * find_longest (const HWID hwid) const
+			{
+				for (const Group &g : _groups) {
+					auto found = g.routes.find (hwid & g.mask);
+					if (found != g.routes.cend ()) {
+						return &(found->second);
+					}
+				}
+				return nullptr;
+			}
+
+			/* Longest match for every HWID, out[i] belongs to hwids[i] */
+			void find_longest (const HWID_VECTOR &hwids, std::vector<const T *> &out) const
+			{
+				out.assign (hwids.size (), nullptr);
+
+				/* Group by group, so every hash table is walked while it's hot in cache */
+				size_t remaining = hwids.size ();
+				for (const Group &g : _groups) {
+					if (0 == remaining) {
+						break;
+					}
+					for (size_t pos = 0; pos < hwids.size (); ++pos) {
+						if (nullptr != out[pos]) {
+							continue;
+						}
+						auto found = g.routes.find (hwids[pos] & g.mask);
+						if (found != g.routes.cend ()) {
+							out[pos] = &(found->second);
+							--remaining;
+						}
+					}
+				}
+			}
+
+			/* Call callback for every route matching hwid, from the longest mask. Callback returning false stops the walk. */
+			template<class F>
+			void for_each_match (const HWID hwid, F callback) const
+			{
+				for (const Group &g : _groups) {
+					auto found = g.routes.find (hwid & g.mask);
+					if (found != g.routes.cend ()) {
+						if (callback (HWIDMASK (found->first, g.mask), found->second) == false) {
+							return;
+						}
+					}
+				}
+			}
+
+			/* All routes matching hwid, from the longest mask */
+			std::vector<const T *> find_all (const HWID hwid) const
+			{
+				std::vector<const T *> out;
+				for_each_match (hwid, [&out](const HWIDMASK &, const T &value) -> bool {
+					out.push_back (&value);
+					return true;
+				});
+				return out;
+			}
+
+			size_t size (void) const
+			{
+				return _size;
+			}
+
+			bool empty (void) const
+			{
+				return (0 == _size);
+			}
+
+			void clear (void)
+			{
+				_groups.clear ();
+				_size = 0;
+			}
+	};
+}
+
+#endif // HEAD_shaga_HWIDTable
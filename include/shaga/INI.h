@@ -185,13 +185,13 @@ namespace shaga {
 			template <typename... Args>
 			void set_format (const std::string_view section, const std::string_view key, const std::string_view format, const Args & ... args)
 			{
-				set_string (section, key, fmt::format (format, args...), false);
+				set_string (section, key, fmt::format (fmt::runtime (format), args...), false);
 			}
 
 			template <typename... Args>
 			void set_format_append (const std::string_view section, const std::string_view key, const std::string_view format, const Args & ... args)
 			{
-				set_string (section, key, fmt::format (format, args...), true);
+				set_string (section, key, fmt::format (fmt::runtime (format), args...), true);
 			}
 
 			size_t erase (const std::string_view section, const std::string_view key);
@@ -0,0 +1,80 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#ifndef HEAD_shaga_LZ
+#define HEAD_shaga_LZ
+
+#include "common.h"
+
+/* Fast LZ compression using LZ4-style sequences (token, literals, 16-bit offset, match length).
+ * Every frame starts with one byte describing its type. Stored frame contains plain data, compressed frame
+ * contains size of plain data (BIN::from_size) followed by sequences. Frame is never more than one byte longer
+ * than the plain data.
+ *
+ * Compressor and Decompressor keep last 64 kB of plain data as a dictionary, so matches can reference
+ * previous frames. Both sides must process all frames in the same order, so it is intended for one link. */
+
+namespace shaga::LZ {
+	static const constexpr uint8_t frame_stored {0x00};
+	static const constexpr uint8_t frame_compressed {0x01};
+
+	static const constexpr size_t dictionary_size {65'536};
+	static const constexpr size_t max_offset {65'535};
+	static const constexpr size_t min_match {4};
+	static const constexpr size_t min_compress_size {16};
+
+	class Compressor {
+		private:
+			static const constexpr uint_fast32_t _hash_bits {12};
+
+			const bool _use_dictionary;
+
+			std::string _window;
+			std::array<uint32_t, (1 << _hash_bits)> _table;
+
+			size_t _last_window_size {0};
+			uint_fast32_t _skip_frames {0};
+			uint_fast32_t _skip_backoff {0};
+
+			bool _compress_block (const size_t start, std::string &out_append, const size_t limit);
+			void _append_stored (const std::string_view plain, std::string &out_append);
+			void _trim_window (void);
+
+		public:
+			explicit Compressor (const bool use_dictionary = true);
+
+			/* Compress plain data and append frame to out_append. Frames that don't compress are stored, and after
+			 * several failed attempts, compression is skipped for a while. */
+			void compress (const std::string_view plain, std::string &out_append);
+			std::string compress (const std::string_view plain);
+
+			/* Forget the last frame, if it was not sent to the other side */
+			void rollback (void);
+
+			void reset (void);
+	};
+
+	class Decompressor {
+		private:
+			const bool _use_dictionary;
+
+			std::string _window;
+
+			void _trim_window (void);
+
+		public:
+			explicit Decompressor (const bool use_dictionary = true);
+
+			/* Decompress one frame and append plain data to out_append */
+			void decompress (const std::string_view frame, std::string &out_append);
+			std::string decompress (const std::string_view frame);
+
+			void reset (void);
+	};
+}
+
+#endif // HEAD_shaga_LZ
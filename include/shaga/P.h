@@ -67,7 +67,7 @@ namespace shaga::P {
 		else {
 			P_CACHE_TYPE &cache = _p_cache_lock ();
 			try {
-				const auto result = fmt::format_to_n (cache.begin (), cache.size (), format, args...);
+				const auto result = fmt::format_to_n (cache.begin (), cache.size (), fmt::runtime (format), args...);
 				_print (std::string_view (cache.data (), std::min (result.size, cache.size ())));
 			}
 			catch (...) {
@@ -93,7 +93,7 @@ namespace shaga::P {
 		else {
 			P_CACHE_TYPE &cache = _p_cache_lock ();
 			try {
-				const auto result = fmt::format_to_n (cache.begin (), cache.size (), format, args...);
+				const auto result = fmt::format_to_n (cache.begin (), cache.size (), fmt::runtime (format), args...);
 				_print (std::string_view (cache.data (), std::min (result.size, cache.size ())), "[DEBUG] "sv);
 			}
 			catch (...) {
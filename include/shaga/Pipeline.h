@@ -0,0 +1,388 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#ifndef HEAD_shaga_Pipeline
+#define HEAD_shaga_Pipeline
+
+#include "common.h"
+
+#ifdef SHAGA_THREADING
+
+/* Multi-threaded pipeline. Stages are connected by SPSC rings carrying batches (std::vector<T>). Batches are moved
+ * from ring to ring, never copied. Every stage runs in its own thread, which can be pinned to one CPU core.
+ * Every ring must have exactly one producer and one consumer, so every ring can be input of only one stage.
+ *
+ * Typical gateway pipeline:
+ *   reader thread -> DecodeSPSC -> [source, ReData::decode] -> [ChunkTool::from_bin] -> [route] -> EncodeSPSC */
+
+namespace shaga {
+	template<class T> using PipelineBatch = std::vector<T>;
+	template<class T> using PipelineRing = SPSC<PipelineBatch<T>>;
+
+	typedef struct {
+		uint64_t batches_in;
+		uint64_t items_in;
+		uint64_t batches_out;
+		uint64_t items_out;
+		uint64_t errors;
+		uint64_t stalls;
+	} PIPELINE_COUNTERS;
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  PipelineStage  //////////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	class PipelineStage
+	{
+		private:
+			const std::string _name;
+			const int _core;
+
+			std::thread _thread;
+			std::atomic<bool> _running {false};
+
+			void _thread_loop (std::promise<int> pinned);
+
+		protected:
+			std::atomic<uint64_t> _batches_in {0};
+			std::atomic<uint64_t> _items_in {0};
+			std::atomic<uint64_t> _batches_out {0};
+			std::atomic<uint64_t> _items_out {0};
+			std::atomic<uint64_t> _errors {0};
+			std::atomic<uint64_t> _stalls {0};
+
+			/* Counters are only statistics, so they don't order anything */
+			static void _count (std::atomic<uint64_t> &counter, const uint64_t val = 1)
+			{
+				counter.fetch_add (val, std::memory_order_relaxed);
+			}
+
+			/* Process at most one batch. Return false if there was nothing to do. */
+			virtual bool _step (void) = 0;
+
+		public:
+			/* Core -1 means the thread is not pinned */
+			PipelineStage (const std::string_view name, const int core);
+			virtual ~PipelineStage ();
+
+			void start (void);
+			void stop (void);
+			bool is_running (void) const;
+
+			const std::string & get_name (void) const;
+			PIPELINE_COUNTERS get_counters (void) const;
+			void reset_counters (void);
+
+			/* Disable copy and assignment */
+			PipelineStage (const PipelineStage &) = delete;
+			PipelineStage& operator= (const PipelineStage &) = delete;
+	};
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  PipelineDecodeSourceStage  //////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	/* First stage of the pipeline. Pops decoded buffers from DecodeSPSC (or any class with pop_buffer (std::string &)),
+	 * optionally decodes them by ReData and pushes them as batches of at most max_batch buffers. Buffers that fail
+	 * to decode are counted as errors and dropped. ReData is used only from this thread. */
+	template<class Decoder>
+	class PipelineDecodeSourceStage : public PipelineStage
+	{
+		private:
+			Decoder &_decoder;
+			PipelineRing<std::string> &_out;
+			ReData *const _redata;
+			const size_t _max_batch;
+
+			PipelineBatch<std::string> _pending;
+			std::string _buf;
+
+			bool _flush (void)
+			{
+				const size_t sze = _pending.size ();
+
+				if (_out.push_back (std::move (_pending)) == false) {
+					_count (_stalls);
+					return false;
+				}
+
+				_count (_batches_out);
+				_count (_items_out, sze);
+				_pending.clear ();
+				return true;
+			}
+
+		protected:
+			virtual bool _step (void) override final
+			{
+				if (_pending.size () >= _max_batch) {
+					/* Output ring was full, don't take more input until batch is forwarded */
+					return _flush ();
+				}
+
+				bool done {false};
+				while (_pending.size () < _max_batch) {
+					try {
+						if (_decoder.pop_buffer (_buf) == false) {
+							break;
+						}
+					}
+					catch (...) {
+						/* Buffer was removed from the ring, but it didn't decompress */
+						_count (_errors);
+						done = true;
+						continue;
+					}
+
+					done = true;
+					_count (_items_in);
+
+					if (nullptr == _redata) {
+						_pending.push_back (std::move (_buf));
+						_buf.clear ();
+						continue;
+					}
+
+					try {
+						_redata->decode (_buf, _pending.emplace_back ());
+					}
+					catch (...) {
+						_count (_errors);
+						_pending.pop_back ();
+					}
+				}
+
+				if (_pending.empty () == false) {
+					_flush ();
+				}
+
+				return done;
+			}
+
+		public:
+			PipelineDecodeSourceStage (const std::string_view name, Decoder &decoder, PipelineRing<std::string> &out, ReData *const redata, const size_t max_batch, const int core) :
+				PipelineStage (name, core),
+				_decoder (decoder),
+				_out (out),
+				_redata (redata),
+				_max_batch (max_batch)
+			{
+				if (0 == _max_batch) {
+					cThrow ("Stage '{}': Batch size must be at least 1"sv, name);
+				}
+				_pending.reserve (_max_batch);
+			}
+
+			virtual ~PipelineDecodeSourceStage ()
+			{
+				stop ();
+			}
+	};
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  PipelineTransformStage  /////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	template<class In, class Out>
+	class PipelineTransformStage : public PipelineStage
+	{
+		public:
+			/* Function reads input batch and appends results to output batch. Input batch may be modified. */
+			typedef std::function<void (PipelineBatch<In> &, PipelineBatch<Out> &)> TransformFunc;
+
+		private:
+			PipelineRing<In> &_in;
+			PipelineRing<Out> &_out;
+			TransformFunc _func;
+
+			PipelineBatch<In> _batch;
+			PipelineBatch<Out> _pending;
+			bool _has_pending {false};
+
+			bool _flush (void)
+			{
+				const size_t sze = _pending.size ();
+
+				if (_out.push_back (std::move (_pending)) == false) {
+					_count (_stalls);
+					return false;
+				}
+
+				_count (_batches_out);
+				_count (_items_out, sze);
+				_pending.clear ();
+				_has_pending = false;
+				return true;
+			}
+
+		protected:
+			virtual bool _step (void) override final
+			{
+				if (true == _has_pending) {
+					/* Output ring was full, don't take more input until result is forwarded */
+					return _flush ();
+				}
+
+				if (_in.pop_front (_batch) == false) {
+					return false;
+				}
+
+				_count (_batches_in);
+				_count (_items_in, _batch.size ());
+
+				try {
+					_func (_batch, _pending);
+				}
+				catch (...) {
+					_count (_errors);
+					_pending.clear ();
+					return true;
+				}
+
+				if (_pending.empty () == false) {
+					_has_pending = true;
+					_flush ();
+				}
+
+				return true;
+			}
+
+		public:
+			PipelineTransformStage (const std::string_view name, PipelineRing<In> &in, PipelineRing<Out> &out, TransformFunc func, const int core) :
+				PipelineStage (name, core),
+				_in (in),
+				_out (out),
+				_func (std::move (func))
+			{ }
+
+			virtual ~PipelineTransformStage ()
+			{
+				stop ();
+			}
+	};
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  PipelineSinkStage  //////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	template<class In>
+	class PipelineSinkStage : public PipelineStage
+	{
+		public:
+			typedef std::function<void (PipelineBatch<In> &)> SinkFunc;
+
+		private:
+			PipelineRing<In> &_in;
+			SinkFunc _func;
+
+			PipelineBatch<In> _batch;
+
+		protected:
+			virtual bool _step (void) override final
+			{
+				if (_in.pop_front (_batch) == false) {
+					return false;
+				}
+
+				_count (_batches_in);
+				_count (_items_in, _batch.size ());
+
+				try {
+					_func (_batch);
+				}
+				catch (...) {
+					_count (_errors);
+				}
+
+				return true;
+			}
+
+		public:
+			PipelineSinkStage (const std::string_view name, PipelineRing<In> &in, SinkFunc func, const int core) :
+				PipelineStage (name, core),
+				_in (in),
+				_func (std::move (func))
+			{ }
+
+			virtual ~PipelineSinkStage ()
+			{
+				stop ();
+			}
+	};
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  Pipeline  ///////////////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	class Pipeline
+	{
+		private:
+			/* Rings are declared before stages, so stages are stopped before rings are destroyed */
+			std::list<std::shared_ptr<void>> _rings;
+			std::vector<std::unique_ptr<PipelineStage>> _stages;
+			bool _running {false};
+
+			void _check_not_running (void) const
+			{
+				if (true == _running) {
+					cThrow ("Pipeline is running"sv);
+				}
+			}
+
+		public:
+			Pipeline () = default;
+			~Pipeline ();
+
+			template<class T>
+			PipelineRing<T> & add_ring (const uint_fast32_t sze)
+			{
+				_check_not_running ();
+				auto ring = std::make_shared<PipelineRing<T>> (sze);
+				_rings.push_back (ring);
+				return *ring;
+			}
+
+			/* Source of the pipeline, redata may be nullptr if buffers are not encrypted */
+			template<class Decoder>
+			PipelineStage & add_source (const std::string_view name, Decoder &decoder, PipelineRing<std::string> &out, ReData *const redata = nullptr, const size_t max_batch = 64, const int core = -1)
+			{
+				_check_not_running ();
+				_stages.push_back (std::make_unique<PipelineDecodeSourceStage<Decoder>> (name, decoder, out, redata, max_batch, core));
+				return *_stages.back ();
+			}
+
+			template<class In, class Out>
+			PipelineStage & add_stage (const std::string_view name, PipelineRing<In> &in, PipelineRing<Out> &out, typename PipelineTransformStage<In, Out>::TransformFunc func, const int core = -1)
+			{
+				_check_not_running ();
+				_stages.push_back (std::make_unique<PipelineTransformStage<In, Out>> (name, in, out, std::move (func), core));
+				return *_stages.back ();
+			}
+
+			template<class In>
+			PipelineStage & add_sink (const std::string_view name, PipelineRing<In> &in, typename PipelineSinkStage<In>::SinkFunc func, const int core = -1)
+			{
+				_check_not_running ();
+				_stages.push_back (std::make_unique<PipelineSinkStage<In>> (name, in, std::move (func), core));
+				return *_stages.back ();
+			}
+
+			void start (void);
+			void stop (void);
+			bool is_running (void) const;
+
+			std::vector<std::pair<std::string, PIPELINE_COUNTERS>> get_counters (void) const;
+			void reset_counters (void);
+
+			/* Disable copy and assignment */
+			Pipeline (const Pipeline &) = delete;
+			Pipeline& operator= (const Pipeline &) = delete;
+	};
+}
+
+#endif // SHAGA_THREADING
+#endif // HEAD_shaga_Pipeline
@@ -28,7 +28,46 @@ namespace shaga
 
 			T* const _data {nullptr};
 
+			/* Number of free slots from position now to the end of array, one slot is always kept empty */
+			uint_fast32_t _contiguous_free (const uint_fast32_t now, const uint_fast32_t read) const
+			{
+				if (read > now) {
+					return read - now - 1;
+				}
+				return _size - now - ((0 == read) ? 1 : 0);
+			}
+
+			/* Number of used slots from position now to the end of array */
+			uint_fast32_t _contiguous_used (const uint_fast32_t now, const uint_fast32_t write) const
+			{
+				if (write >= now) {
+					return write - now;
+				}
+				return _size - now;
+			}
+
 		public:
+			/* Contiguous range of slots inside the ring */
+			class Span
+			{
+				private:
+					T* _ptr {nullptr};
+					uint_fast32_t _size {0};
+
+				public:
+					Span () = default;
+					Span (T *const ptr, const uint_fast32_t sze) : _ptr (ptr), _size (sze) {}
+
+					T* data (void) const { return _ptr; }
+					uint_fast32_t size (void) const { return _size; }
+					bool empty (void) const { return 0 == _size; }
+
+					T* begin (void) const { return _ptr; }
+					T* end (void) const { return _ptr + _size; }
+
+					T& operator[] (const uint_fast32_t pos) const { return _ptr[pos]; }
+			};
+
 			template<class ...Args>
 			explicit PreAllocSPSC (const uint_fast32_t sze, Args&&... args) :
 				_size (sze),
@@ -168,9 +207,87 @@ namespace shaga
 				#endif // SHAGA_THREADING
 			}
 
+			/* Return up to n free slots following each other in memory, starting at back (). Span can be shorter
+			 * than requested when the ring wraps around, empty span means the ring is full.
+			 * Slots are published by commit (). */
+			Span reserve (const uint_fast32_t n)
+			{
+				#ifdef SHAGA_THREADING
+					const uint_fast32_t now = _pos_write.load (std::memory_order_relaxed);
+					const uint_fast32_t avail = _contiguous_free (now, _pos_read.load (std::memory_order_acquire));
+				#else
+					const uint_fast32_t now = _pos_write;
+					const uint_fast32_t avail = _contiguous_free (now, _pos_read);
+				#endif // SHAGA_THREADING
+
+				return Span (&_data[now], std::min (n, avail));
+			}
+
+			/* Publish first k slots returned by reserve () with one store */
+			void commit (const uint_fast32_t k)
+			{
+				#ifdef SHAGA_THREADING
+					const uint_fast32_t now = _pos_write.load (std::memory_order_relaxed);
+					if (k > _contiguous_free (now, _pos_read.load (std::memory_order_acquire))) {
+				#else
+					const uint_fast32_t now = _pos_write;
+					if (HEDLEY_UNLIKELY (k > _contiguous_free (now, _pos_read))) {
+				#endif // SHAGA_THREADING
+					cThrow ("Commit of {} slots exceeds free space"sv, k);
+				}
+
+				const uint_fast32_t next = (now + k) % _size;
+
+				#ifdef SHAGA_THREADING
+					_pos_write.store (next, std::memory_order_release);
+				#else
+					_pos_write = next;
+				#endif // SHAGA_THREADING
+			}
+
+			/* Return up to n used slots following each other in memory, starting at front (). Span can be shorter
+			 * than number of used slots when the ring wraps around, empty span means the ring is empty.
+			 * Slots are released by release (). */
+			Span front_span (const uint_fast32_t n = UINT_FAST32_MAX)
+			{
+				#ifdef SHAGA_THREADING
+					const uint_fast32_t now = _pos_read.load (std::memory_order_relaxed);
+					const uint_fast32_t avail = _contiguous_used (now, _pos_write.load (std::memory_order_acquire));
+				#else
+					const uint_fast32_t now = _pos_read;
+					const uint_fast32_t avail = _contiguous_used (now, _pos_write);
+				#endif // SHAGA_THREADING
+
+				return Span (&_data[now], std::min (n, avail));
+			}
+
+			/* Release first k slots returned by front_span () with one store */
+			void release (const uint_fast32_t k)
+			{
+				#ifdef SHAGA_THREADING
+					const uint_fast32_t now = _pos_read.load (std::memory_order_relaxed);
+					if (k > _contiguous_used (now, _pos_write.load (std::memory_order_acquire))) {
+				#else
+					const uint_fast32_t now = _pos_read;
+					if (HEDLEY_UNLIKELY (k > _contiguous_used (now, _pos_write))) {
+				#endif // SHAGA_THREADING
+					cThrow ("Release of {} slots exceeds used space"sv, k);
+				}
+
+				const uint_fast32_t next = (now + k) % _size;
+
+				#ifdef SHAGA_THREADING
+					_pos_read.store (next, std::memory_order_release);
+				#else
+					_pos_read = next;
+				#endif // SHAGA_THREADING
+			}
+
 			void clear (void)
 			{
-				while (pop_front () == true);
+				for (Span span = front_span (); span.empty () == false; span = front_span ()) {
+					release (span.size ());
+				}
 			}
 
 			bool empty (void) const
@@ -53,33 +53,33 @@ namespace shaga::STR {
 	template <typename... Args>
 	void sprint (std::string &append_to, const std::string_view format, const Args & ... args)
 	{
-		const size_t sze = fmt::formatted_size (format, args...);
+		const size_t sze = fmt::formatted_size (fmt::runtime (format), args...);
 		append_to.reserve (append_to.size () + sze);
-		fmt::format_to (std::back_inserter(append_to), format, args...);
+		fmt::format_to (std::back_inserter(append_to), fmt::runtime (format), args...);
 	}
 
 	template <typename... Args>
 	std::string sprint (const std::string_view format, const Args & ... args)
 	{
-		return fmt::format (format, args...);
+		return fmt::format (fmt::runtime (format), args...);
 	}
 
 	template <typename... Args>
 	void sprint (COMMON_VECTOR &vout, const std::string_view format, const Args & ... args)
 	{
-		vout.push_back (fmt::format (format, args...));
+		vout.push_back (fmt::format (fmt::runtime (format), args...));
 	}
 
 	template <typename... Args>
 	void sprint (COMMON_LIST &vout, const std::string_view format, const Args & ... args)
 	{
-		vout.push_back (fmt::format (format, args...));
+		vout.push_back (fmt::format (fmt::runtime (format), args...));
 	}
 
 	template <typename... Args>
 	void sprint (COMMON_DEQUE &vout, const std::string_view format, const Args & ... args)
 	{
-		vout.push_back (fmt::format (format, args...));
+		vout.push_back (fmt::format (fmt::runtime (format), args...));
 	}
 
 	bool to_bool (const std::string_view s, const int base = 10);
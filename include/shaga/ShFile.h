@@ -213,13 +213,13 @@ namespace shaga {
 			template <typename... Args>
 			void print (const std::string_view format, const Args & ... args)
 			{
-				write (fmt::format (format, args...));
+				write (fmt::format (fmt::runtime (format), args...));
 			}
 
 			template <typename... Args>
 			void format (const std::string_view format, const Args & ... args)
 			{
-				write (fmt::format (format, args...));
+				write (fmt::format (fmt::runtime (format), args...));
 			}
 
 			bool read (std::string &data, const size_t len, const bool thr_eof = true);
@@ -121,6 +121,11 @@ All rights reserved.
 #include <random>
 #include <chrono>
 
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+	#include <coroutine>
+	#define SHAGA_COROUTINES
+#endif // __cpp_impl_coroutine
+
 #include <sys/types.h>
 #include <sys/stat.h>
 
@@ -129,6 +134,7 @@ All rights reserved.
 	#include <mutex>
 	#include <atomic>
 	#include <condition_variable>
+	#include <future>
 #endif // SHAGA_THREADING
 
 #ifdef OS_LINUX
@@ -369,7 +375,7 @@ namespace shaga
 			shaga::_exit (format, rcode);
 		}
 		try {
-			shaga::_exit (fmt::format (format, args...), rcode);
+			shaga::_exit (fmt::format (fmt::runtime (format), args...), rcode);
 		}
 		catch (...) {
 			shaga::_exit (format, rcode);
@@ -383,7 +389,7 @@ namespace shaga
 			shaga::_exit (format, EXIT_FAILURE);
 		}
 		try {
-			shaga::_exit (fmt::format (format, args...), EXIT_FAILURE);
+			shaga::_exit (fmt::format (fmt::runtime (format), args...), EXIT_FAILURE);
 		}
 		catch (...) {
 			shaga::_exit (format, EXIT_FAILURE);
@@ -504,16 +510,29 @@ namespace shaga
 #include "BINstatic.h"
 #include "BIN.h"
 #include "hwid.h"
+#include "HWIDTable.h"
 #include "CRC.h"
+#include "LZ.h"
 #include "Digest.h"
 #include "DiSig.h"
 #include "ShSocket.h"
 #include "ShFile.h"
 #include "FS.h"
 #include "json.h"
+#include "CBOR.h"
 #include "ChunkMeta.h"
 #include "Chunk.h"
+#include "ChunkView.h"
+#include "ChunkDedup.h"
+#include "ChunkPool.h"
+#include "ChunkShared.h"
+#include "ChunkBuckets.h"
+#include "ChunkPrioSet.h"
+#include "ChunkPrioQueue.h"
+#include "ChunkDispatch.h"
 #include "ChunkTool.h"
+#include "ChunkPack.h"
+#include "ChunkSpecialTypes.h"
 #include "ReData.h"
 #include "INI.h"
 #include "UNIX.h"
@@ -532,6 +551,8 @@ namespace shaga
 #include "SPSCData.h"
 #include "EncodeSPSC.h"
 #include "DecodeSPSC.h"
+#include "Pipeline.h"
+#include "CoSPSC.h"
 
 namespace shaga
 {
@@ -966,27 +966,41 @@ namespace shaga {
 
 	void BIN::from_size (const size_t sze, std::string& s)
 	{
+		char buf[4];
+		size_t pos {0};
+		_from_size (sze, buf, pos);
+		s.append (buf, pos);
+	}
+
+	void BIN::_from_size (const size_t sze, void *const buf, size_t &pos)
+	{
+		uint8_t *const out = reinterpret_cast<uint8_t *> (buf) + pos;
+
 		if (sze <= 0x7F) {
 			// 0b0xxx'xxxx = 1 byte
-			s.push_back (static_cast<uint8_t> (sze));
+			out[0] = static_cast<uint8_t> (sze);
+			pos += 1;
 		}
 		else if (sze <= 0x3FFF) {
 			// 0b10xx'xxxx  yyyy'yyyy = 2 bytes
-			s.push_back (static_cast<uint8_t> (0b1000'0000 | ((sze >> 8) & 0x3F)));
-			s.push_back (static_cast<uint8_t> (sze & 0xFF));
+			out[0] = static_cast<uint8_t> (0b1000'0000 | ((sze >> 8) & 0x3F));
+			out[1] = static_cast<uint8_t> (sze & 0xFF);
+			pos += 2;
 		}
 		else if (sze <= 0x1FFFFF) {
 			// 0b110x'xxxx  yyyy'yyyy  zzzz'zzzz = 3 bytes
-			s.push_back (static_cast<uint8_t> (0b1100'0000 | ((sze >> 16) & 0x1F)));
-			s.push_back (static_cast<uint8_t> ((sze >> 8) & 0xFF));
-			s.push_back (static_cast<uint8_t> (sze & 0xFF));
+			out[0] = static_cast<uint8_t> (0b1100'0000 | ((sze >> 16) & 0x1F));
+			out[1] = static_cast<uint8_t> ((sze >> 8) & 0xFF);
+			out[2] = static_cast<uint8_t> (sze & 0xFF);
+			pos += 3;
 		}
 		else if (sze <= 0xFFFFFFF) {
 			// 0b1110'xxxx  yyyy'yyyy  zzzz'zzzz  aaaa'aaaa = 4 bytes
-			s.push_back (static_cast<uint8_t> (0b1110'0000 | ((sze >> 24) & 0xF)));
-			s.push_back (static_cast<uint8_t> ((sze >> 16) & 0xFF));
-			s.push_back (static_cast<uint8_t> ((sze >> 8) & 0xFF));
-			s.push_back (static_cast<uint8_t> (sze & 0xFF));
+			out[0] = static_cast<uint8_t> (0b1110'0000 | ((sze >> 24) & 0xF));
+			out[1] = static_cast<uint8_t> ((sze >> 16) & 0xFF);
+			out[2] = static_cast<uint8_t> ((sze >> 8) & 0xFF);
+			out[3] = static_cast<uint8_t> (sze & 0xFF);
+			pos += 4;
 		}
 		else {
 			cThrow ("Unable to encode size larger than 0xFFFFFFF"sv);
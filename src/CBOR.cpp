@@ -0,0 +1,609 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#include "shaga/common.h"
+
+namespace shaga::CBOR {
+	static const constexpr uint8_t _major_unsigned {0};
+	static const constexpr uint8_t _major_negative {1};
+	static const constexpr uint8_t _major_bytes {2};
+	static const constexpr uint8_t _major_text {3};
+	static const constexpr uint8_t _major_array {4};
+	static const constexpr uint8_t _major_map {5};
+	static const constexpr uint8_t _major_tag {6};
+	static const constexpr uint8_t _major_simple {7};
+
+	static const constexpr uint8_t _info_uint8 {24};
+	static const constexpr uint8_t _info_uint16 {25};
+	static const constexpr uint8_t _info_uint32 {26};
+	static const constexpr uint8_t _info_uint64 {27};
+	static const constexpr uint8_t _info_indefinite {31};
+
+	static const constexpr uint8_t _simple_false {20};
+	static const constexpr uint8_t _simple_true {21};
+	static const constexpr uint8_t _simple_null {22};
+	static const constexpr uint8_t _simple_undefined {23};
+
+	static const constexpr uint8_t _byte_break {0xFF};
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  Static functions  ///////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	static double _half_to_double (const uint16_t half)
+	{
+		const int exp = (half >> 10) & 0x1F;
+		const int mant = half & 0x3FF;
+		double val;
+
+		if (0 == exp) {
+			val = std::ldexp (mant, -24);
+		}
+		else if (31 != exp) {
+			val = std::ldexp (mant + 1024, exp - 25);
+		}
+		else {
+			val = (0 == mant) ? std::numeric_limits<double>::infinity () : std::numeric_limits<double>::quiet_NaN ();
+		}
+
+		return (half & 0x8000) ? -val : val;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  Writer  /////////////////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void Writer::_head (const uint8_t major, const uint64_t val)
+	{
+		uint8_t out[9];
+		size_t len {1};
+
+		if (val < _info_uint8) {
+			out[0] = (major << 5) | static_cast<uint8_t> (val);
+		}
+		else if (val <= UINT8_MAX) {
+			out[0] = (major << 5) | _info_uint8;
+			out[1] = static_cast<uint8_t> (val);
+			len = 2;
+		}
+		else if (val <= UINT16_MAX) {
+			out[0] = (major << 5) | _info_uint16;
+			BIN::_be_from_uint16 (static_cast<uint16_t> (val), out + 1);
+			len = 3;
+		}
+		else if (val <= UINT32_MAX) {
+			out[0] = (major << 5) | _info_uint32;
+			BIN::_be_from_uint32 (static_cast<uint32_t> (val), out + 1);
+			len = 5;
+		}
+		else {
+			out[0] = (major << 5) | _info_uint64;
+			BIN::_be_from_uint64 (val, out + 1);
+			len = 9;
+		}
+
+		_buf.insert (_buf.end (), out, out + len);
+	}
+
+	Writer::Writer (const size_t reserve_size)
+	{
+		_buf.reserve (reserve_size);
+	}
+
+	Writer & Writer::array (const size_t items)
+	{
+		if (indefinite == items) {
+			_buf.push_back ((_major_array << 5) | _info_indefinite);
+		}
+		else {
+			_head (_major_array, items);
+		}
+		return *this;
+	}
+
+	Writer & Writer::map (const size_t items)
+	{
+		if (indefinite == items) {
+			_buf.push_back ((_major_map << 5) | _info_indefinite);
+		}
+		else {
+			_head (_major_map, items);
+		}
+		return *this;
+	}
+
+	Writer & Writer::end (void)
+	{
+		_buf.push_back (_byte_break);
+		return *this;
+	}
+
+	Writer & Writer::tag (const uint64_t tag)
+	{
+		_head (_major_tag, tag);
+		return *this;
+	}
+
+	Writer & Writer::null (void)
+	{
+		_buf.push_back ((_major_simple << 5) | _simple_null);
+		return *this;
+	}
+
+	Writer & Writer::value (const bool val)
+	{
+		_buf.push_back ((_major_simple << 5) | (val ? _simple_true : _simple_false));
+		return *this;
+	}
+
+	Writer & Writer::value (const uint64_t val)
+	{
+		_head (_major_unsigned, val);
+		return *this;
+	}
+
+	Writer & Writer::value (const int64_t val)
+	{
+		if (val >= 0) {
+			_head (_major_unsigned, static_cast<uint64_t> (val));
+		}
+		else {
+			/* -1 - val without overflow */
+			_head (_major_negative, ~static_cast<uint64_t> (val));
+		}
+		return *this;
+	}
+
+	Writer & Writer::value (const double val)
+	{
+		uint8_t out[9];
+
+		/* Use single precision if it's lossless */
+		if (std::isfinite (val) == false || (std::fabs (val) <= static_cast<double> (std::numeric_limits<float>::max ()) && static_cast<double> (static_cast<float> (val)) == val)) {
+			const float fval = static_cast<float> (val);
+			uint32_t bits;
+			::memcpy (&bits, &fval, sizeof (bits));
+			out[0] = (_major_simple << 5) | _info_uint32;
+			BIN::_be_from_uint32 (bits, out + 1);
+			_buf.insert (_buf.end (), out, out + 5);
+		}
+		else {
+			uint64_t bits;
+			::memcpy (&bits, &val, sizeof (bits));
+			out[0] = (_major_simple << 5) | _info_uint64;
+			BIN::_be_from_uint64 (bits, out + 1);
+			_buf.insert (_buf.end (), out, out + 9);
+		}
+		return *this;
+	}
+
+	Writer & Writer::value (const std::string_view val)
+	{
+		_head (_major_text, val.size ());
+		_buf.insert (_buf.end (), val.begin (), val.end ());
+		return *this;
+	}
+
+	Writer & Writer::value (const char *const val)
+	{
+		return value (std::string_view (val));
+	}
+
+	Writer & Writer::bytes (const std::string_view val)
+	{
+		_head (_major_bytes, val.size ());
+		_buf.insert (_buf.end (), val.begin (), val.end ());
+		return *this;
+	}
+
+	Writer & Writer::bytes (const void *const data, const size_t len)
+	{
+		return bytes (std::string_view (reinterpret_cast<const char *> (data), len));
+	}
+
+	size_t Writer::size (void) const
+	{
+		return _buf.size ();
+	}
+
+	bool Writer::empty (void) const
+	{
+		return _buf.empty ();
+	}
+
+	void Writer::clear (void)
+	{
+		_buf.resize (0);
+	}
+
+	const std::vector<uint8_t> & Writer::data (void) const
+	{
+		return _buf;
+	}
+
+	std::vector<uint8_t> Writer::release (void)
+	{
+		std::vector<uint8_t> out;
+		out.swap (_buf);
+		return out;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  Reader  /////////////////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	uint8_t Reader::_peek_byte (void) const
+	{
+		if (HEDLEY_UNLIKELY (_offset >= _buf.size ())) {
+			cThrow ("Not enough data in buffer"sv);
+		}
+		return static_cast<uint8_t> (_buf[_offset]);
+	}
+
+	uint64_t Reader::_argument (const uint8_t info)
+	{
+		if (info < _info_uint8) {
+			return info;
+		}
+
+		size_t len;
+		switch (info) {
+			case _info_uint8: len = 1; break;
+			case _info_uint16: len = 2; break;
+			case _info_uint32: len = 4; break;
+			case _info_uint64: len = 8; break;
+			default: cThrow ("Unsupported CBOR additional information {}"sv, info);
+		}
+
+		if (HEDLEY_UNLIKELY ((_offset + len) > _buf.size ())) {
+			cThrow ("Not enough data in buffer"sv);
+		}
+
+		const char *const ptr = _buf.data () + _offset;
+		_offset += len;
+
+		switch (len) {
+			case 1: return static_cast<uint8_t> (*ptr);
+			case 2: return BIN::_be_to_uint16 (ptr);
+			case 4: return BIN::_be_to_uint32 (ptr);
+			default: return BIN::_be_to_uint64 (ptr);
+		}
+	}
+
+	uint64_t Reader::_head (const uint8_t expected_major, uint8_t &info)
+	{
+		const uint8_t byte = _peek_byte ();
+		if (HEDLEY_UNLIKELY ((byte >> 5) != expected_major)) {
+			cThrow ("Unexpected CBOR major type {}, expected {}"sv, byte >> 5, expected_major);
+		}
+
+		info = byte & 0x1F;
+		++_offset;
+
+		if (_info_indefinite == info) {
+			return 0;
+		}
+		return _argument (info);
+	}
+
+	size_t Reader::_container (const uint8_t major)
+	{
+		uint8_t info;
+		const uint64_t items = _head (major, info);
+		if (_info_indefinite == info) {
+			return indefinite;
+		}
+
+		/* Every item is at least one byte long */
+		if (HEDLEY_UNLIKELY (items > (_buf.size () - _offset))) {
+			cThrow ("Not enough data in buffer"sv);
+		}
+		return static_cast<size_t> (items);
+	}
+
+	std::string_view Reader::_string (const uint8_t major)
+	{
+		const size_t start {_offset};
+		uint8_t info;
+		const uint64_t len = _head (major, info);
+
+		if (HEDLEY_UNLIKELY (_info_indefinite == info)) {
+			_offset = start;
+			cThrow ("Indefinite length strings are not supported"sv);
+		}
+
+		if (HEDLEY_UNLIKELY (len > (_buf.size () - _offset))) {
+			_offset = start;
+			cThrow ("Not enough data in buffer"sv);
+		}
+
+		const std::string_view out = _buf.substr (_offset, len);
+		_offset += len;
+		return out;
+	}
+
+	void Reader::_skip (const size_t depth)
+	{
+		if (HEDLEY_UNLIKELY (depth > max_depth)) {
+			cThrow ("CBOR nesting is too deep"sv);
+		}
+
+		const uint8_t byte = _peek_byte ();
+		const uint8_t major = byte >> 5;
+		const uint8_t info = byte & 0x1F;
+
+		if (_byte_break == byte) {
+			cThrow ("Unexpected CBOR break"sv);
+		}
+
+		++_offset;
+
+		if (_info_indefinite == info) {
+			if (HEDLEY_UNLIKELY (major != _major_bytes && major != _major_text && major != _major_array && major != _major_map)) {
+				cThrow ("Malformed CBOR item"sv);
+			}
+
+			/* Items (or string chunks) until break */
+			while (_peek_byte () != _byte_break) {
+				_skip (depth + 1);
+			}
+			++_offset;
+			return;
+		}
+
+		const uint64_t arg = _argument (info);
+
+		switch (major) {
+			case _major_bytes:
+			case _major_text:
+				if (HEDLEY_UNLIKELY (arg > (_buf.size () - _offset))) {
+					cThrow ("Not enough data in buffer"sv);
+				}
+				_offset += arg;
+				break;
+
+			case _major_array:
+				for (uint64_t i = 0; i < arg; ++i) {
+					_skip (depth + 1);
+				}
+				break;
+
+			case _major_map:
+				for (uint64_t i = 0; i < arg; ++i) {
+					_skip (depth + 1);
+					_skip (depth + 1);
+				}
+				break;
+
+			case _major_tag:
+				_skip (depth + 1);
+				break;
+
+			default:
+				/* Integers and simple values are already consumed */
+				break;
+		}
+	}
+
+	Reader::Reader (const std::string_view buf) :
+		_buf (buf)
+	{}
+
+	Reader::Reader (const std::vector<uint8_t> &buf) :
+		_buf (reinterpret_cast<const char *> (buf.data ()), buf.size ())
+	{}
+
+	Type Reader::peek (void) const
+	{
+		if (_offset >= _buf.size ()) {
+			return Type::END;
+		}
+
+		const uint8_t byte = static_cast<uint8_t> (_buf[_offset]);
+
+		switch (byte >> 5) {
+			case _major_unsigned: return Type::UNSIGNED;
+			case _major_negative: return Type::NEGATIVE;
+			case _major_bytes: return Type::BYTES;
+			case _major_text: return Type::TEXT;
+			case _major_array: return Type::ARRAY;
+			case _major_map: return Type::MAP;
+			case _major_tag: return Type::TAG;
+		}
+
+		switch (byte & 0x1F) {
+			case _simple_false:
+			case _simple_true:
+				return Type::BOOL;
+			case _simple_null:
+				return Type::NUL;
+			case _simple_undefined:
+				return Type::UNDEFINED;
+			case _info_uint16:
+			case _info_uint32:
+			case _info_uint64:
+				return Type::FLOAT;
+			case _info_indefinite:
+				return Type::BREAK;
+			default:
+				return Type::UNDEFINED;
+		}
+	}
+
+	bool Reader::at_end (void) const
+	{
+		return (_offset >= _buf.size ());
+	}
+
+	size_t Reader::get_offset (void) const
+	{
+		return _offset;
+	}
+
+	uint64_t Reader::read_uint (void)
+	{
+		const size_t start {_offset};
+		uint8_t info;
+		const uint64_t val = _head (_major_unsigned, info);
+		if (HEDLEY_UNLIKELY (_info_indefinite == info)) {
+			_offset = start;
+			cThrow ("Malformed CBOR integer"sv);
+		}
+		return val;
+	}
+
+	int64_t Reader::read_int (void)
+	{
+		const size_t start {_offset};
+		const bool negative = ((_peek_byte () >> 5) == _major_negative);
+		uint8_t info;
+		const uint64_t val = _head (negative ? _major_negative : _major_unsigned, info);
+
+		if (HEDLEY_UNLIKELY (_info_indefinite == info || val > static_cast<uint64_t> (INT64_MAX))) {
+			_offset = start;
+			cThrow ("CBOR integer is out of range"sv);
+		}
+
+		return negative ? (-1 - static_cast<int64_t> (val)) : static_cast<int64_t> (val);
+	}
+
+	double Reader::read_double (void)
+	{
+		const uint8_t byte = _peek_byte ();
+
+		switch (byte >> 5) {
+			case _major_unsigned:
+				return static_cast<double> (read_uint ());
+
+			case _major_negative: {
+				uint8_t info;
+				const uint64_t val = _head (_major_negative, info);
+				return -1.0 - static_cast<double> (val);
+			}
+
+			case _major_simple:
+				break;
+
+			default:
+				cThrow ("Unexpected CBOR major type {}, expected number"sv, byte >> 5);
+		}
+
+		const uint8_t info = byte & 0x1F;
+		if (_info_uint16 != info && _info_uint32 != info && _info_uint64 != info) {
+			cThrow ("CBOR value is not a number"sv);
+		}
+
+		++_offset;
+		const uint64_t bits = _argument (info);
+
+		if (_info_uint16 == info) {
+			return _half_to_double (static_cast<uint16_t> (bits));
+		}
+		else if (_info_uint32 == info) {
+			const uint32_t bits32 = static_cast<uint32_t> (bits);
+			float val;
+			::memcpy (&val, &bits32, sizeof (val));
+			return val;
+		}
+		else {
+			double val;
+			::memcpy (&val, &bits, sizeof (val));
+			return val;
+		}
+	}
+
+	bool Reader::read_bool (void)
+	{
+		const uint8_t byte = _peek_byte ();
+		if (byte == ((_major_simple << 5) | _simple_true)) {
+			++_offset;
+			return true;
+		}
+		else if (byte == ((_major_simple << 5) | _simple_false)) {
+			++_offset;
+			return false;
+		}
+		cThrow ("CBOR value is not a boolean"sv);
+	}
+
+	void Reader::read_null (void)
+	{
+		if (_peek_byte () != ((_major_simple << 5) | _simple_null)) {
+			cThrow ("CBOR value is not null"sv);
+		}
+		++_offset;
+	}
+
+	uint64_t Reader::read_tag (void)
+	{
+		const size_t start {_offset};
+		uint8_t info;
+		const uint64_t val = _head (_major_tag, info);
+		if (HEDLEY_UNLIKELY (_info_indefinite == info)) {
+			_offset = start;
+			cThrow ("Malformed CBOR tag"sv);
+		}
+		return val;
+	}
+
+	SHAGA_STRV std::string_view Reader::read_text (void)
+	{
+		return _string (_major_text);
+	}
+
+	SHAGA_STRV std::string_view Reader::read_bytes (void)
+	{
+		return _string (_major_bytes);
+	}
+
+	size_t Reader::read_array (void)
+	{
+		return _container (_major_array);
+	}
+
+	size_t Reader::read_map (void)
+	{
+		return _container (_major_map);
+	}
+
+	bool Reader::read_break (void)
+	{
+		if (_offset < _buf.size () && static_cast<uint8_t> (_buf[_offset]) == _byte_break) {
+			++_offset;
+			return true;
+		}
+		return false;
+	}
+
+	void Reader::skip (void)
+	{
+		_skip (0);
+	}
+
+	bool Reader::find_key (const std::string_view key)
+	{
+		const size_t items = read_map ();
+
+		for (size_t i = 0; i < items; ++i) {
+			if (indefinite == items && read_break () == true) {
+				return false;
+			}
+
+			if (peek () == Type::TEXT) {
+				if (read_text () == key) {
+					return true;
+				}
+			}
+			else {
+				skip ();
+			}
+			skip ();
+		}
+
+		return false;
+	}
+}
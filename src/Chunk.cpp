@@ -90,6 +90,11 @@ namespace shaga {
 	}
 
 	uint32_t Chunk::generate_header (char *const out, size_t &offset, const SPECIAL_TYPES *const special_types) const
+	{
+		return _generate_header (out, offset, special_types, this->has_payload (), this->has_cbor (), true);
+	}
+
+	uint32_t Chunk::_generate_header (char *const out, size_t &offset, const SPECIAL_TYPES *const special_types, const bool with_payload, const bool with_cbor, const bool with_source) const
 	{
 		uint32_t val {key_highbit_mask};
 
@@ -101,11 +106,11 @@ namespace shaga {
 			val |= key_channel_mask;
 		}
 
-		if (this->has_payload ()) {
+		if (true == with_payload) {
 			val |= key_has_payload_mask;
 		}
 
-		if (this->has_cbor ()) {
+		if (true == with_cbor) {
 			val |= key_has_cbor_mask;
 		}
 
@@ -136,7 +141,9 @@ namespace shaga {
 			BIN::_be_from_uint32 (val, out, offset);
 		}
 
-		_bin_from_hwid (_hwid_source, out, offset);
+		if (true == with_source) {
+			_bin_from_hwid (_hwid_source, out, offset);
+		}
 
 		return val;
 	}
@@ -144,6 +151,11 @@ namespace shaga {
 	void Chunk::_reset (void)
 	{
 		_construct ();
+		_clear ();
+	}
+
+	void Chunk::_clear (void)
+	{
 		_channel = true;
 		_hwid_source = HWID_UNKNOWN;
 		_type = 0;
@@ -153,13 +165,29 @@ namespace shaga {
 		_trust = TrustLevel::INTERNAL;
 		_ttl = max_ttl;
 		_hwid_dest = HWIDMASK ();
-		_tracert_hops.clear ();
+		_tracert_hops_count = 0;
 
 		meta.reset ();
 
 		invalidate_stored_binary_representation ();
 	}
 
+	size_t Chunk::_get_capacity (void) const
+	{
+		return _payload.capacity () + _cbor.capacity () + _stored_binary.capacity () + meta.get_capacity ();
+	}
+
+	uint_fast64_t Chunk::_reserve_counters (const size_t cnt)
+	{
+		#ifdef SHAGA_THREADING
+			return _chunk_global_counter.fetch_add (cnt, std::memory_order_relaxed);
+		#else
+			const uint_fast64_t first = _chunk_global_counter;
+			_chunk_global_counter += cnt;
+			return first;
+		#endif // SHAGA_THREADING
+	}
+
 	void Chunk::_construct (void)
 	{
 		#ifdef SHAGA_THREADING
@@ -181,13 +209,25 @@ namespace shaga {
 
 	Chunk::Chunk (const std::string_view bin, size_t &offset, const SPECIAL_TYPES *const special_types, bool store_binary_representation)
 	{
-		if (should_continue (bin, offset) == false) {
-			cThrow ("Buffer is empty"sv);
-		}
-		_reset ();
+		from_bin (bin, offset, special_types, store_binary_representation);
+	}
 
-		const size_t start_offset {offset};
+	Chunk::Chunk (const _KeepCounter, const uint_fast64_t counter) :
+		_counter (counter)
+	{ }
 
+	Chunk::Chunk (const HWID hwid_source, const std::string_view type)
+	{
+		reset (hwid_source, type);
+	}
+
+	Chunk::Chunk (const HWID hwid_source, const uint32_t type)
+	{
+		reset (hwid_source, type);
+	}
+
+	uint32_t Chunk::_header_from_bin (const std::string_view bin, size_t &offset, const SPECIAL_TYPES *const special_types)
+	{
 		/* Read high 16-bit first (big endian) */
 		const uint32_t val = BIN::be_to_uint16 (bin, offset) << 16;
 
@@ -204,13 +244,15 @@ namespace shaga {
 
 		if ((val & key_tracert_mask) == key_tracert_mask) {
 			_type = key_type_tracert;
-			store_binary_representation = false;
 		}
 		else if (val & key_special_type_mask) {
 			if (special_types == nullptr) {
 				cThrow ("Required special_types are not defined"sv);
 			}
 			_type = special_types->at ((val >> 16) & num_special_types);
+			if (HEDLEY_UNLIKELY (0 == _type)) {
+				cThrow ("Special type is not defined"sv);
+			}
 		}
 		else {
 			/* This is not tracert type, so read the rest of the 32-bit header */
@@ -220,26 +262,26 @@ namespace shaga {
 
 		_check_key_validity (_type);
 
-		_hwid_source = bin_to_hwid (bin, offset);
-
-		_stored_header_size = offset - start_offset;
-
-		if (key_type_tracert == _type) {
-			const uint_fast32_t hop_counter = BIN::to_uint8 (bin, offset);
+		return val;
+	}
 
-			for (uint_fast32_t i = 0; i < hop_counter; ++i) {
-				TRACERT_HOP hop;
-				hop.hwid = bin_to_hwid (bin, offset);
-				hop.metric = BIN::to_uint8 (bin, offset);
-				_tracert_hops.push_back (std::move (hop));
-			}
+	void Chunk::_hops_from_bin (const std::string_view bin, size_t &offset)
+	{
+		const uint_fast32_t hop_counter = BIN::to_uint8 (bin, offset);
+		if (hop_counter > max_hop_counter) {
+			cThrow ("Too many tracert hops ({})"sv, hop_counter);
 		}
 
-		if (val & key_has_dest_mask) {
-			_hwid_dest.mask = bin_to_hwid (bin, offset);
-			_hwid_dest.hwid = bin_to_hwid (bin, offset);
+		for (uint_fast32_t i = 0; i < hop_counter; ++i) {
+			TRACERT_HOP &hop = _tracert_hops[i];
+			hop.hwid = bin_to_hwid (bin, offset);
+			hop.metric = BIN::to_uint8 (bin, offset);
 		}
+		_tracert_hops_count = hop_counter;
+	}
 
+	void Chunk::_body_from_bin (const std::string_view bin, size_t &offset, const uint32_t val)
+	{
 		if (val & key_has_payload_mask) {
 			const size_t len = BIN::to_size (bin, offset);
 			if ((offset + len) > bin.size ()) {
@@ -264,6 +306,42 @@ namespace shaga {
 		}
 
 		meta.from_bin (bin, offset);
+	}
+
+	void Chunk::from_bin (const std::string_view bin, size_t &offset, const SPECIAL_TYPES *const special_types, bool store_binary_representation)
+	{
+		_construct ();
+		_from_bin (bin, offset, special_types, store_binary_representation);
+	}
+
+	void Chunk::_from_bin (const std::string_view bin, size_t &offset, const SPECIAL_TYPES *const special_types, bool store_binary_representation)
+	{
+		if (should_continue (bin, offset) == false) {
+			cThrow ("Buffer is empty"sv);
+		}
+		_clear ();
+
+		const size_t start_offset {offset};
+
+		const uint32_t val = _header_from_bin (bin, offset, special_types);
+		if (key_type_tracert == _type) {
+			store_binary_representation = false;
+		}
+
+		_hwid_source = bin_to_hwid (bin, offset);
+
+		_stored_header_size = offset - start_offset;
+
+		if (key_type_tracert == _type) {
+			_hops_from_bin (bin, offset);
+		}
+
+		if (val & key_has_dest_mask) {
+			_hwid_dest.mask = bin_to_hwid (bin, offset);
+			_hwid_dest.hwid = bin_to_hwid (bin, offset);
+		}
+
+		_body_from_bin (bin, offset, val);
 
 		if (true == store_binary_representation) {
 			/* Save binary representation if requested and this is not tracert chunk */
@@ -274,14 +352,16 @@ namespace shaga {
 		}
 	}
 
-	Chunk::Chunk (const HWID hwid_source, const std::string_view type)
+	void Chunk::reset (const HWID hwid_source, const std::string_view type)
 	{
+		const uint32_t num_type = key_to_bin (type);
+
 		_reset ();
 		_hwid_source = hwid_source;
-		_type = key_to_bin (type);
+		_type = num_type;
 	}
 
-	Chunk::Chunk (const HWID hwid_source, const uint32_t type)
+	void Chunk::reset (const HWID hwid_source, const uint32_t type)
 	{
 		if (type < Chunk::key_type_min || type > Chunk::key_type_max) {
 			cThrow ("Unrecognized key value {:X}"sv, type);
@@ -294,10 +374,11 @@ namespace shaga {
 
 	size_t Chunk::get_max_bytes (void) const
 	{
-		size_t len {8};
+		/* Header, tracert hop counter and sizes of payload and CBOR */
+		size_t len {4 + 1 + 4 + 4};
 
 		len += sizeof (HWID) * 3;
-		len += _tracert_hops.size () * (sizeof (HWID) + 1);
+		len += _tracert_hops_count * (sizeof (HWID) + 1);
 		len += get_payload<std::string_view> ().size ();
 		len += _cbor.size ();
 
@@ -450,6 +531,11 @@ namespace shaga {
 		return _cbor;
 	}
 
+	CBOR::Reader Chunk::get_cbor_reader (void) const
+	{
+		return CBOR::Reader (_cbor);
+	}
+
 	void Chunk::set_prio (const Chunk::Priority prio)
 	{
 		_prio = prio;
@@ -531,26 +617,25 @@ namespace shaga {
 
 	bool Chunk::tracert_hops_add (const shaga::HWID hwid, const uint8_t metric)
 	{
-		if (key_type_tracert != _type || _tracert_hops.size () >= max_hop_counter) {
+		if (key_type_tracert != _type || _tracert_hops_count >= max_hop_counter) {
 			return false;
 		}
 
-		TRACERT_HOP hop;
+		TRACERT_HOP &hop = _tracert_hops[_tracert_hops_count++];
 		hop.hwid = hwid;
 		hop.metric = metric;
-		_tracert_hops.push_back (std::move (hop));
 
 		return true;
 	}
 
-	std::list<Chunk::TRACERT_HOP> Chunk::tracert_hops_get (void) const
+	Chunk::TracertHops Chunk::tracert_hops_get (void) const
 	{
-		return _tracert_hops;
+		return TracertHops (_tracert_hops.data (), _tracert_hops_count);
 	}
 
 	size_t Chunk::tracert_hops_count (void) const
 	{
-		return _tracert_hops.size ();
+		return _tracert_hops_count;
 	}
 
 	HWIDMASK Chunk::get_destination_hwidmask (void) const
@@ -658,33 +743,46 @@ namespace shaga {
 	}
 
 	void Chunk::to_bin (std::string &out_append, const SPECIAL_TYPES *const special_types) const
+	{
+		_head_to_bin (out_append, special_types, has_payload (), has_cbor ());
+		_body_to_bin (out_append);
+	}
+
+	void Chunk::_head_to_bin (std::string &out_append, const SPECIAL_TYPES *const special_types, const bool with_payload, const bool with_cbor) const
 	{
 		size_t offset {0};
 		char header[8];
-		const uint32_t val = generate_header (header, offset, special_types);
+		const uint32_t val = _generate_header (header, offset, special_types, with_payload, with_cbor, true);
 
 		out_append.append (header, offset);
 
 		if (key_type_tracert == _type) {
-			BIN::from_uint8 (_tracert_hops.size (), out_append);
-			for (const auto &hop : _tracert_hops) {
-				bin_from_hwid (hop.hwid, out_append);
-				BIN::from_uint8 (hop.metric, out_append);
-			}
+			_hops_to_bin (out_append);
 		}
 
 		if (val & key_has_dest_mask) {
 			bin_from_hwid (_hwid_dest.mask, out_append);
 			bin_from_hwid (_hwid_dest.hwid, out_append);
 		}
+	}
 
-		if (val & key_has_payload_mask) {
-			const auto payload = get_payload<std::string_view> ();
-			BIN::from_size (payload.size (), out_append);
-			out_append.append (payload);
+	void Chunk::_hops_to_bin (std::string &out_append) const
+	{
+		BIN::from_uint8 (_tracert_hops_count, out_append);
+		for (const auto &hop : tracert_hops_get ()) {
+			bin_from_hwid (hop.hwid, out_append);
+			BIN::from_uint8 (hop.metric, out_append);
 		}
+	}
 
-		if (val & key_has_cbor_mask) {
+	void Chunk::_body_to_bin (std::string &out_append) const
+	{
+		if (has_payload () == true) {
+			BIN::from_size (_payload.size (), out_append);
+			out_append.append (_payload);
+		}
+
+		if (has_cbor () == true) {
 			BIN::from_size (_cbor.size (), out_append);
 			out_append.append (reinterpret_cast<const char *> (_cbor.data ()), _cbor.size ());
 		}
@@ -700,6 +798,39 @@ namespace shaga {
 		return out;
 	}
 
+	void Chunk::to_bin (char *const out, size_t &offset, const SPECIAL_TYPES *const special_types) const
+	{
+		const uint32_t val = generate_header (out, offset, special_types);
+
+		if (key_type_tracert == _type) {
+			BIN::_from_uint8 (_tracert_hops_count, out, offset);
+			for (const auto &hop : tracert_hops_get ()) {
+				_bin_from_hwid (hop.hwid, out, offset);
+				BIN::_from_uint8 (hop.metric, out, offset);
+			}
+		}
+
+		if (val & key_has_dest_mask) {
+			_bin_from_hwid (_hwid_dest.mask, out, offset);
+			_bin_from_hwid (_hwid_dest.hwid, out, offset);
+		}
+
+		if (val & key_has_payload_mask) {
+			const auto payload = get_payload<std::string_view> ();
+			BIN::_from_size (payload.size (), out, offset);
+			::memcpy (out + offset, payload.data (), payload.size ());
+			offset += payload.size ();
+		}
+
+		if (val & key_has_cbor_mask) {
+			BIN::_from_size (_cbor.size (), out, offset);
+			::memcpy (out + offset, _cbor.data (), _cbor.size ());
+			offset += _cbor.size ();
+		}
+
+		meta.to_bin (out, offset);
+	}
+
 	bool operator== (const Chunk &a, const Chunk &b)
 	{
 		return a.compare (b) == 0;
@@ -0,0 +1,158 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#include "shaga/common.h"
+
+namespace shaga {
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  ChunkBuckets::const_iterator  ///////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	ChunkBuckets::const_iterator::const_iterator (const ChunkBuckets *const owner, const size_t bucket, const size_t pos) :
+		_owner (owner),
+		_bucket (bucket),
+		_pos (pos)
+	{
+		_skip_empty ();
+	}
+
+	void ChunkBuckets::const_iterator::_skip_empty (void)
+	{
+		while (_bucket < num_buckets && _pos >= _owner->_buckets[_bucket].size ()) {
+			++_bucket;
+			_pos = 0;
+		}
+	}
+
+	ChunkBuckets::const_iterator::reference ChunkBuckets::const_iterator::operator* (void) const
+	{
+		return _owner->_buckets[_bucket][_pos];
+	}
+
+	ChunkBuckets::const_iterator::pointer ChunkBuckets::const_iterator::operator-> (void) const
+	{
+		return &(_owner->_buckets[_bucket][_pos]);
+	}
+
+	ChunkBuckets::const_iterator & ChunkBuckets::const_iterator::operator++ (void)
+	{
+		++_pos;
+		_skip_empty ();
+		return *this;
+	}
+
+	ChunkBuckets::const_iterator ChunkBuckets::const_iterator::operator++ (int)
+	{
+		const_iterator tmp = *this;
+		++(*this);
+		return tmp;
+	}
+
+	bool ChunkBuckets::const_iterator::operator== (const const_iterator &other) const
+	{
+		return _owner == other._owner && _bucket == other._bucket && _pos == other._pos;
+	}
+
+	bool ChunkBuckets::const_iterator::operator!= (const const_iterator &other) const
+	{
+		return !(*this == other);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  Private class methods  //////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	size_t ChunkBuckets::_bucket_index (const Chunk::Priority prio)
+	{
+		const size_t idx = static_cast<size_t> (prio);
+		if (HEDLEY_UNLIKELY (idx >= num_buckets)) {
+			cThrow ("Priority is out of range"sv);
+		}
+		return idx;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  Public class methods  ///////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	size_t ChunkBuckets::size (void) const
+	{
+		return _size;
+	}
+
+	bool ChunkBuckets::empty (void) const
+	{
+		return (0 == _size);
+	}
+
+	void ChunkBuckets::clear (void)
+	{
+		for (auto &bucket : _buckets) {
+			bucket.clear ();
+		}
+		_size = 0;
+	}
+
+	const std::deque<Chunk> & ChunkBuckets::bucket (const Chunk::Priority prio) const
+	{
+		return _buckets[_bucket_index (prio)];
+	}
+
+	size_t ChunkBuckets::bucket_size (const Chunk::Priority prio) const
+	{
+		return _buckets[_bucket_index (prio)].size ();
+	}
+
+	void ChunkBuckets::erase_front (const Chunk::Priority prio, const size_t cnt)
+	{
+		auto &bucket = _buckets[_bucket_index (prio)];
+
+		if (cnt > bucket.size ()) {
+			cThrow ("Unable to erase {} chunks, bucket contains only {}"sv, cnt, bucket.size ());
+		}
+
+		bucket.erase (bucket.begin (), bucket.begin () + cnt);
+		_size -= cnt;
+	}
+
+	void ChunkBuckets::truncate (const Chunk::Priority prio, const size_t cnt)
+	{
+		auto &bucket = _buckets[_bucket_index (prio)];
+
+		if (cnt >= bucket.size ()) {
+			return;
+		}
+
+		_size -= bucket.size () - cnt;
+		bucket.erase (bucket.begin () + cnt, bucket.end ());
+	}
+
+	void ChunkBuckets::purge (std::function<bool (const Chunk &)> callback)
+	{
+		if (nullptr == callback) {
+			cThrow ("Callback function is not defined"sv);
+		}
+
+		for (auto &bucket : _buckets) {
+			auto iter = std::remove_if (bucket.begin (), bucket.end (), [&callback](const Chunk &chunk) -> bool {
+				return callback (chunk) == false;
+			});
+			_size -= std::distance (iter, bucket.end ());
+			bucket.erase (iter, bucket.end ());
+		}
+	}
+
+	ChunkBuckets::const_iterator ChunkBuckets::begin (void) const
+	{
+		return const_iterator (this, 0, 0);
+	}
+
+	ChunkBuckets::const_iterator ChunkBuckets::end (void) const
+	{
+		return const_iterator (this, num_buckets, 0);
+	}
+}
@@ -0,0 +1,173 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#include "shaga/common.h"
+
+namespace shaga {
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  Static functions  ///////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	static Digest::SipHash128_t _chunkdedup_random_key (void)
+	{
+		randutils::mt19937_r_rng rng;
+		return Digest::SipHash128_t (rng.uniform<uint64_t> (0, UINT64_MAX), rng.uniform<uint64_t> (0, UINT64_MAX));
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  Private class methods  //////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	uint64_t ChunkDedup::_hash (const ChunkView &view) const
+	{
+		const std::string_view bin = view.get_binary ();
+		const size_t header_size = view.get_header_size ();
+
+		/* Tracert hops (counter and list) follow the header */
+		size_t body_start = header_size;
+		if (Chunk::key_type_tracert == view.get_num_type ()) {
+			body_start += 1 + (view.tracert_hops_count () * (sizeof (HWID) + 1));
+		}
+
+		/* Header with TTL cleared (at most 4 bytes of header and source HWID), followed by hash of the body */
+		char buf[16];
+		::memcpy (buf, bin.data (), header_size);
+		buf[0] = static_cast<char> (static_cast<uint8_t> (buf[0]) & ~static_cast<uint8_t> (Chunk::key_ttl_mask >> 24));
+
+		size_t len = header_size;
+		BIN::_from_uint64 (Digest::siphash24_64t (bin.data () + body_start, bin.size () - body_start, _key), buf, len);
+
+		const uint64_t hash = Digest::siphash24_64t (buf, len, _key);
+
+		/* Zero marks empty slot */
+		return (0 == hash) ? 1 : hash;
+	}
+
+	bool ChunkDedup::_contains (const size_t gen, const uint64_t hash) const
+	{
+		const std::vector<uint64_t> &table = _gen[gen];
+
+		for (size_t i = 0; i < _max_probe; ++i) {
+			const uint64_t val = table[(hash + i) & _mask];
+			if (val == hash) {
+				return true;
+			}
+			if (0 == val) {
+				return false;
+			}
+		}
+		return false;
+	}
+
+	bool ChunkDedup::_insert (const size_t gen, const uint64_t hash)
+	{
+		std::vector<uint64_t> &table = _gen[gen];
+
+		for (size_t i = 0; i < _max_probe; ++i) {
+			uint64_t &val = table[(hash + i) & _mask];
+			if (0 == val) {
+				val = hash;
+				++_gen_size[gen];
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void ChunkDedup::_rotate (const uint64_t now_msec)
+	{
+		_current ^= 1;
+		std::fill (_gen[_current].begin (), _gen[_current].end (), 0);
+		_gen_size[_current] = 0;
+		_rotated_msec = now_msec;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  Public class methods  ///////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	ChunkDedup::ChunkDedup (const size_t capacity, const uint64_t period_msec, const Chunk::SPECIAL_TYPES *const special_types) :
+		ChunkDedup (capacity, period_msec, _chunkdedup_random_key (), special_types)
+	{}
+
+	ChunkDedup::ChunkDedup (const size_t capacity, const uint64_t period_msec, const Digest::SipHash128_t &key, const Chunk::SPECIAL_TYPES *const special_types) :
+		_key (key),
+		_capacity (capacity),
+		_period_msec (period_msec),
+		_special_types (special_types)
+	{
+		if (0 == capacity) {
+			cThrow ("Capacity must be greater than zero"sv);
+		}
+
+		/* Keep tables at most half full, so probing stays short */
+		size_t slots = 16;
+		while (slots < (capacity * 2)) {
+			slots <<= 1;
+		}
+		_mask = slots - 1;
+
+		for (auto &table : _gen) {
+			table.assign (slots, 0);
+		}
+	}
+
+	bool ChunkDedup::is_duplicate (const ChunkView &view, const uint64_t now_msec)
+	{
+		const uint64_t hash = _hash (view);
+
+		if (UINT64_MAX == _rotated_msec) {
+			_rotated_msec = now_msec;
+		}
+		else if (now_msec >= (_rotated_msec + _period_msec)) {
+			const bool both_expired = (now_msec >= (_rotated_msec + (2 * _period_msec)));
+			_rotate (now_msec);
+			if (true == both_expired) {
+				_rotate (now_msec);
+			}
+		}
+
+		if (_contains (_current, hash) == true || _contains (_current ^ 1, hash) == true) {
+			return true;
+		}
+
+		if (_gen_size[_current] >= _capacity || _insert (_current, hash) == false) {
+			_rotate (now_msec);
+			_insert (_current, hash);
+		}
+
+		return false;
+	}
+
+	bool ChunkDedup::is_duplicate (const Chunk &chunk, const uint64_t now_msec)
+	{
+		_temp_bin.resize (0);
+		chunk.to_bin (_temp_bin, _special_types);
+
+		size_t offset {0};
+		return is_duplicate (ChunkView (_temp_bin, offset, _special_types), now_msec);
+	}
+
+	bool ChunkDedup::is_duplicate (const std::string_view buf, size_t &offset, const uint64_t now_msec)
+	{
+		return is_duplicate (ChunkView (buf, offset, _special_types), now_msec);
+	}
+
+	void ChunkDedup::clear (void)
+	{
+		for (size_t gen = 0; gen < _gen.size (); ++gen) {
+			std::fill (_gen[gen].begin (), _gen[gen].end (), 0);
+			_gen_size[gen] = 0;
+		}
+		_rotated_msec = UINT64_MAX;
+	}
+
+	size_t ChunkDedup::size (void) const
+	{
+		return _gen_size[0] + _gen_size[1];
+	}
+}
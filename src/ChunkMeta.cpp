@@ -13,6 +13,21 @@ namespace shaga {
 	//  Static functions  ///////////////////////////////////////////////////////////////////////////////////////////
 	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+	/* Compare entries only by key, used for binary search in sorted data */
+	struct _ChunkMetaKeyCompare
+	{
+		bool operator() (const ChunkMetaEntry &a, const uint_fast16_t key) const noexcept { return a.first < key; }
+		bool operator() (const uint_fast16_t key, const ChunkMetaEntry &a) const noexcept { return key < a.first; }
+	};
+
+	/* Stable, so repeated keys keep order of insertion */
+	static void _sort_by_key (ChunkMetaData &data)
+	{
+		std::stable_sort (data.begin (), data.end (), [](const ChunkMetaEntry &a, const ChunkMetaEntry &b) -> bool {
+			return a.first < b.first;
+		});
+	}
+
 	static inline uint16_t _key_char_to_val (const unsigned char c)
 	{
 		if (c == '_') {
@@ -84,6 +99,36 @@ namespace shaga {
 		return (static_cast<uint8_t> (s[offset]) & 0x80) == 0;
 	}
 
+	std::pair<ChunkMetaData::iterator, ChunkMetaData::iterator> ChunkMeta::_equal_range (const uint16_t key) noexcept
+	{
+		return std::equal_range (_data.begin (), _data.end (), key, _ChunkMetaKeyCompare ());
+	}
+
+	void ChunkMeta::_emplace (const uint16_t key, std::string &&value)
+	{
+		/* Entries usually arrive in order of keys, so they are just appended */
+		if (_data.empty () == true || _data.back ().first <= key) {
+			_data.emplace_back (key, std::move (value));
+		}
+		else {
+			/* Upper bound, so repeated keys keep order of insertion */
+			_data.emplace (std::upper_bound (_data.begin (), _data.end (), key, _ChunkMetaKeyCompare ()), key, std::move (value));
+		}
+	}
+
+	std::optional<uint32_t> ChunkMeta::_get_uint24 (const uint16_t key) const noexcept
+	{
+		ChunkMetaData::const_iterator iter = find (key);
+		if (iter == cend () || iter->second.size () < 3) {
+			return std::nullopt;
+		}
+
+		/* Same layout as BIN::from_uint24 */
+		size_t pos {0};
+		const uint32_t val = BIN::_to_uint16 (iter->second.data (), pos);
+		return val | (static_cast<uint32_t> (BIN::_to_uint8 (iter->second.data (), pos)) << 16);
+	}
+
 	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	//  Public class methods  ///////////////////////////////////////////////////////////////////////////////////////
 	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -94,34 +139,34 @@ namespace shaga {
 	ChunkMeta::ChunkMeta (const uint16_t key)
 	{
 		_check_key_validity (key, nullptr);
-		_data.emplace (key, std::string ());
+		_emplace (key, std::string ());
 	}
 
 	ChunkMeta::ChunkMeta (const uint16_t key, const std::string_view value)
 	{
 		_check_key_validity (key, nullptr);
-		_data.emplace (key, value);
+		_emplace (key, std::string (value));
 	}
 
 	ChunkMeta::ChunkMeta (const uint16_t key, std::string &&value)
 	{
 		_check_key_validity (key, nullptr);
-		_data.emplace (key, std::move (value));
+		_emplace (key, std::move (value));
 	}
 
 	ChunkMeta::ChunkMeta (const std::string_view key)
 	{
-		_data.emplace (key_to_bin (key), std::string ());
+		_emplace (key_to_bin (key), std::string ());
 	}
 
 	ChunkMeta::ChunkMeta (const std::string_view key, const std::string_view value)
 	{
-		_data.emplace (key_to_bin (key), value);
+		_emplace (key_to_bin (key), std::string (value));
 	}
 
 	ChunkMeta::ChunkMeta (const std::string_view key, std::string &&value)
 	{
-		_data.emplace (key_to_bin (key), std::move (value));
+		_emplace (key_to_bin (key), std::move (value));
 	}
 
 	ChunkMetaData::const_iterator ChunkMeta::begin () const noexcept
@@ -146,12 +191,16 @@ namespace shaga {
 
 	ChunkMetaData::const_iterator ChunkMeta::find (const std::string_view key) const
 	{
-		return _data.find (key_to_bin (key));
+		return find (key_to_bin (key));
 	}
 
 	ChunkMetaData::const_iterator ChunkMeta::find (const uint16_t key) const noexcept
 	{
-		return _data.find (key);
+		auto iter = std::lower_bound (_data.cbegin (), _data.cend (), key, _ChunkMetaKeyCompare ());
+		if (iter != _data.cend () && iter->first == key) {
+			return iter;
+		}
+		return _data.cend ();
 	}
 
 	void ChunkMeta::clear (void) noexcept
@@ -167,34 +216,34 @@ namespace shaga {
 	void ChunkMeta::add_value (const uint16_t key)
 	{
 		_check_key_validity (key, nullptr);
-		_data.emplace (key, std::string ());
+		_emplace (key, std::string ());
 	}
 
 	void ChunkMeta::add_value (const std::string_view key)
 	{
-		_data.emplace (key_to_bin (key), std::string ());
+		_emplace (key_to_bin (key), std::string ());
 	}
 
 	void ChunkMeta::add_value (const uint16_t key, const std::string_view value)
 	{
 		_check_key_validity (key, nullptr);
-		_data.emplace (key, value);
+		_emplace (key, std::string (value));
 	}
 
 	void ChunkMeta::add_value (const std::string_view key, const std::string_view value)
 	{
-		_data.emplace (key_to_bin (key), value);
+		_emplace (key_to_bin (key), std::string (value));
 	}
 
 	void ChunkMeta::add_value (const uint16_t key, std::string &&value)
 	{
 		_check_key_validity (key, nullptr);
-		_data.emplace (key, std::move (value));
+		_emplace (key, std::move (value));
 	}
 
 	void ChunkMeta::add_value (const std::string_view key, std::string &&value)
 	{
-		_data.emplace (key_to_bin (key), std::move (value));
+		_emplace (key_to_bin (key), std::move (value));
 	}
 
 	void ChunkMeta::add_bool (const uint16_t key, const bool value)
@@ -329,6 +378,17 @@ namespace shaga {
 		return len;
 	}
 
+	size_t ChunkMeta::get_capacity (void) const noexcept
+	{
+		size_t len = _data.capacity () * sizeof (ChunkMetaEntry);
+
+		for (const auto &entry : _data) {
+			len += entry.second.capacity ();
+		}
+
+		return len;
+	}
+
 	size_t ChunkMeta::size (void) const noexcept
 	{
 		return _data.size ();
@@ -336,12 +396,13 @@ namespace shaga {
 
 	size_t ChunkMeta::count (const std::string_view key) const
 	{
-		return _data.count (key_to_bin (key));
+		return count (key_to_bin (key));
 	}
 
 	size_t ChunkMeta::count (const uint16_t key) const noexcept
 	{
-		return _data.count (key);
+		auto [i_begin, i_end] = equal_range (key);
+		return std::distance (i_begin, i_end);
 	}
 
 	bool ChunkMeta::empty (void) const noexcept
@@ -352,7 +413,11 @@ namespace shaga {
 	size_t ChunkMeta::erase (const uint16_t key)
 	{
 		_check_key_validity (key, nullptr);
-		return _data.erase (key);
+
+		auto [i_begin, i_end] = _equal_range (key);
+		const size_t cnt = std::distance (i_begin, i_end);
+		_data.erase (i_begin, i_end);
+		return cnt;
 	}
 
 	size_t ChunkMeta::erase (const std::string_view key)
@@ -362,41 +427,32 @@ namespace shaga {
 
 	void ChunkMeta::unique (void)
 	{
-		ChunkMetaDataSet temp;
-		std::move (_data.begin (), _data.end (), std::inserter (temp, temp.begin ()));
-		_data.clear ();
-		std::move (temp.begin (), temp.end (), std::inserter (_data, _data.begin ()));
+		/* Sorted by key and value, same as if it went through ChunkMetaDataSet */
+		std::sort (_data.begin (), _data.end ());
+		_data.erase (std::unique (_data.begin (), _data.end ()), _data.end ());
 	}
 
 	void ChunkMeta::merge (const ChunkMeta &other)
 	{
-		ChunkMetaDataSet temp;
-		std::move (_data.begin (), _data.end (), std::inserter (temp, temp.begin ()));
-		std::copy (other._data.cbegin (), other._data.cend (), std::inserter (temp, temp.begin ()));
-
-		_data.clear ();
-		std::move (temp.begin (), temp.end (), std::inserter (_data, _data.begin ()));
+		_data.insert (_data.end (), other._data.cbegin (), other._data.cend ());
+		unique ();
 	}
 
 	void ChunkMeta::merge (ChunkMeta &&other)
 	{
-		ChunkMetaDataSet temp;
-		std::move (_data.begin (), _data.end (), std::inserter (temp, temp.end ()));
-		std::move (other._data.begin (), other._data.end (), std::inserter (temp, temp.end ()));
+		_data.insert (_data.end (), std::make_move_iterator (other._data.begin ()), std::make_move_iterator (other._data.end ()));
 		other.clear ();
-
-		_data.clear ();
-		std::move (temp.begin (), temp.end (), std::inserter (_data, _data.end ()));
+		unique ();
 	}
 
 	ChunkMetaDataRange ChunkMeta::equal_range (const std::string_view key) const
 	{
-		return _data.equal_range (key_to_bin (key));
+		return equal_range (key_to_bin (key));
 	}
 
 	ChunkMetaDataRange ChunkMeta::equal_range (const uint16_t key) const noexcept
 	{
-		return _data.equal_range (key);
+		return std::equal_range (_data.cbegin (), _data.cend (), key, _ChunkMetaKeyCompare ());
 	}
 
 	void ChunkMeta::modify_values (const std::string_view key, ValuesCallback callback)
@@ -406,13 +462,13 @@ namespace shaga {
 
 	void ChunkMeta::modify_values (const uint16_t key, ValuesCallback callback)
 	{
-		auto [i_begin, i_end] = _data.equal_range (key);
+		auto [i_begin, i_end] = _equal_range (key);
 
 		if (i_begin == i_end) {
 			/* No entries, add a new one */
 			std::string str;
 			callback (str);
-			_data.emplace (key, std::move (str));
+			_emplace (key, std::move (str));
 		}
 		else {
 			for (auto iter = i_begin; iter != i_end; ++iter) {
@@ -424,238 +480,214 @@ namespace shaga {
 		}
 	}
 
-#define get_uint_helper(type,sze) \
-	const auto val = get_value (key); \
-	if (val.size () < sze) { \
-		return default_value; \
-	} \
-	else { \
-		return BIN::type (val.data ()); \
-	}
-
 	bool ChunkMeta::get_bool (const std::string_view key, const bool default_value) const
 	{
-		auto fn = [this, &key, default_value]() -> uint8_t {
-			get_uint_helper (_to_uint8, 1)
-		};
-
-		return (0 != fn ());
+		return get_bool (key_to_bin (key), default_value);
 	}
 
 	bool ChunkMeta::get_bool (const uint16_t key, const bool default_value) const noexcept
 	{
-		auto fn = [this, &key, default_value]() -> uint8_t {
-			get_uint_helper (_to_uint8, 1)
-		};
-
-		return (0 != fn ());
+		const auto val = _get_number<uint8_t> (key);
+		if (val.has_value () == false) {
+			return default_value;
+		}
+		return (0 != *val);
 	}
 
 	uint8_t ChunkMeta::get_uint8 (const std::string_view key, const uint8_t default_value) const
 	{
-		get_uint_helper (_to_uint8, 1)
+		return get_uint8 (key_to_bin (key), default_value);
 	}
 
 	uint8_t ChunkMeta::get_uint8 (const uint16_t key, const uint8_t default_value) const noexcept
 	{
-		get_uint_helper (_to_uint8, 1)
+		return _get_number<uint8_t> (key).value_or (default_value);
 	}
 
 	int8_t ChunkMeta::get_int8 (const std::string_view key, const int8_t default_value) const
 	{
-		get_uint_helper (to_int8, 1)
+		return get_int8 (key_to_bin (key), default_value);
 	}
 
 	int8_t ChunkMeta::get_int8 (const uint16_t key, const int8_t default_value) const noexcept
 	{
-		get_uint_helper (to_int8, 1)
+		return _get_number<int8_t> (key).value_or (default_value);
 	}
 
 	uint16_t ChunkMeta::get_uint16 (const std::string_view key, const uint16_t default_value) const
 	{
-		get_uint_helper (_to_uint16, 2)
+		return get_uint16 (key_to_bin (key), default_value);
 	}
 
 	uint16_t ChunkMeta::get_uint16 (const uint16_t key, const uint16_t default_value) const noexcept
 	{
-		get_uint_helper (_to_uint16, 2)
+		return _get_number<uint16_t> (key).value_or (default_value);
 	}
 
 	int16_t ChunkMeta::get_int16 (const std::string_view key, const int16_t default_value) const
 	{
-		get_uint_helper (to_int16, 2)
+		return get_int16 (key_to_bin (key), default_value);
 	}
 
 	int16_t ChunkMeta::get_int16 (const uint16_t key, const int16_t default_value) const noexcept
 	{
-		get_uint_helper (to_int16, 2)
+		return _get_number<int16_t> (key).value_or (default_value);
 	}
 
 	uint32_t ChunkMeta::get_uint24 (const std::string_view key, const uint32_t default_value) const
 	{
-		get_uint_helper (to_uint24, 3)
+		return get_uint24 (key_to_bin (key), default_value);
 	}
 
 	uint32_t ChunkMeta::get_uint24 (const uint16_t key, const uint32_t default_value) const noexcept
 	{
-		get_uint_helper (to_uint24, 3)
+		return _get_uint24 (key).value_or (default_value);
 	}
 
 	uint32_t ChunkMeta::get_uint32 (const std::string_view key, const uint32_t default_value) const
 	{
-		get_uint_helper (_to_uint32, 4)
+		return get_uint32 (key_to_bin (key), default_value);
 	}
 
 	uint32_t ChunkMeta::get_uint32 (const uint16_t key, const uint32_t default_value) const noexcept
 	{
-		get_uint_helper (_to_uint32, 4)
+		return _get_number<uint32_t> (key).value_or (default_value);
 	}
 
 	int32_t ChunkMeta::get_int32 (const std::string_view key, const int32_t default_value) const
 	{
-		get_uint_helper (to_int32, 4)
+		return get_int32 (key_to_bin (key), default_value);
 	}
 
 	int32_t ChunkMeta::get_int32 (const uint16_t key, const int32_t default_value) const noexcept
 	{
-		get_uint_helper (to_int32, 4)
+		return _get_number<int32_t> (key).value_or (default_value);
 	}
 
 	uint64_t ChunkMeta::get_uint64 (const std::string_view key, const uint64_t default_value) const
 	{
-		get_uint_helper (_to_uint64, 8)
+		return get_uint64 (key_to_bin (key), default_value);
 	}
 
 	uint64_t ChunkMeta::get_uint64 (const uint16_t key, const uint64_t default_value) const noexcept
 	{
-		get_uint_helper (_to_uint64, 8)
+		return _get_number<uint64_t> (key).value_or (default_value);
 	}
 
 	int64_t ChunkMeta::get_int64 (const std::string_view key, const int64_t default_value) const
 	{
-		get_uint_helper (to_int64, 8)
+		return get_int64 (key_to_bin (key), default_value);
 	}
 
 	int64_t ChunkMeta::get_int64 (const uint16_t key, const int64_t default_value) const noexcept
 	{
-		get_uint_helper (to_int64, 8)
+		return _get_number<int64_t> (key).value_or (default_value);
 	}
 
 	std::optional<bool> ChunkMeta::get_bool_optional (const std::string_view key) const
 	{
-		const auto val = get_value (key);
-		if (val.size () < 1) {
-			return std::nullopt;
-		}
-
-		return (0 != BIN::_to_uint8 (val.data ()));
+		return get_bool_optional (key_to_bin (key));
 	}
 
 	std::optional<bool> ChunkMeta::get_bool_optional (const uint16_t key) const noexcept
 	{
-		const auto val = get_value (key);
-		if (val.size () < 1) {
+		const auto val = _get_number<uint8_t> (key);
+		if (val.has_value () == false) {
 			return std::nullopt;
 		}
-
-		return (0 != BIN::_to_uint8 (val.data ()));
+		return (0 != *val);
 	}
 
-#define default_value std::nullopt
-
 	std::optional<uint8_t> ChunkMeta::get_uint8_optional (const std::string_view key) const
 	{
-		get_uint_helper (_to_uint8, 1)
+		return get_uint8_optional (key_to_bin (key));
 	}
 
 	std::optional<uint8_t> ChunkMeta::get_uint8_optional (const uint16_t key) const noexcept
 	{
-		get_uint_helper (_to_uint8, 1)
+		return _get_number<uint8_t> (key);
 	}
 
 	std::optional<int8_t> ChunkMeta::get_int8_optional (const std::string_view key) const
 	{
-		get_uint_helper (to_int8, 1)
+		return get_int8_optional (key_to_bin (key));
 	}
 
 	std::optional<int8_t> ChunkMeta::get_int8_optional (const uint16_t key) const noexcept
 	{
-		get_uint_helper (to_int8, 1)
+		return _get_number<int8_t> (key);
 	}
 
 	std::optional<uint16_t> ChunkMeta::get_uint16_optional (const std::string_view key) const
 	{
-		get_uint_helper (_to_uint16, 2)
+		return get_uint16_optional (key_to_bin (key));
 	}
 
 	std::optional<uint16_t> ChunkMeta::get_uint16_optional (const uint16_t key) const noexcept
 	{
-		get_uint_helper (_to_uint16, 2)
+		return _get_number<uint16_t> (key);
 	}
 
 	std::optional<int16_t> ChunkMeta::get_int16_optional (const std::string_view key) const
 	{
-		get_uint_helper (to_int16, 2)
+		return get_int16_optional (key_to_bin (key));
 	}
 
 	std::optional<int16_t> ChunkMeta::get_int16_optional (const uint16_t key) const noexcept
 	{
-		get_uint_helper (to_int16, 2)
+		return _get_number<int16_t> (key);
 	}
 
 	std::optional<uint32_t> ChunkMeta::get_uint24_optional (const std::string_view key) const
 	{
-		get_uint_helper (to_uint24, 3)
+		return get_uint24_optional (key_to_bin (key));
 	}
 
 	std::optional<uint32_t> ChunkMeta::get_uint24_optional (const uint16_t key) const noexcept
 	{
-		get_uint_helper (to_uint24, 3)
+		return _get_uint24 (key);
 	}
 
 	std::optional<uint32_t> ChunkMeta::get_uint32_optional (const std::string_view key) const
 	{
-		get_uint_helper (_to_uint32, 4)
+		return get_uint32_optional (key_to_bin (key));
 	}
 
 	std::optional<uint32_t> ChunkMeta::get_uint32_optional (const uint16_t key) const noexcept
 	{
-		get_uint_helper (_to_uint32, 4)
+		return _get_number<uint32_t> (key);
 	}
 
 	std::optional<int32_t> ChunkMeta::get_int32_optional (const std::string_view key) const
 	{
-		get_uint_helper (to_int32, 4)
+		return get_int32_optional (key_to_bin (key));
 	}
 
 	std::optional<int32_t> ChunkMeta::get_int32_optional (const uint16_t key) const noexcept
 	{
-		get_uint_helper (to_int32, 4)
+		return _get_number<int32_t> (key);
 	}
 
 	std::optional<uint64_t> ChunkMeta::get_uint64_optional (const std::string_view key) const
 	{
-		get_uint_helper (_to_uint64, 8)
+		return get_uint64_optional (key_to_bin (key));
 	}
 
 	std::optional<uint64_t> ChunkMeta::get_uint64_optional (const uint16_t key) const noexcept
 	{
-		get_uint_helper (_to_uint64, 8)
+		return _get_number<uint64_t> (key);
 	}
 
 	std::optional<int64_t> ChunkMeta::get_int64_optional (const std::string_view key) const
 	{
-		get_uint_helper (to_int64, 8)
+		return get_int64_optional (key_to_bin (key));
 	}
 
 	std::optional<int64_t> ChunkMeta::get_int64_optional (const uint16_t key) const noexcept
 	{
-		get_uint_helper (to_int64, 8)
+		return _get_number<int64_t> (key);
 	}
 
-#undef default_value
-#undef get_uint_helper
-
 	void ChunkMeta::modify_value (const std::string_view key, ValueCallback callback)
 	{
 		modify_value (key_to_bin (key), callback);
@@ -663,14 +695,14 @@ namespace shaga {
 
 	void ChunkMeta::modify_value (const uint16_t key, ValueCallback callback)
 	{
-		ChunkMetaData::iterator iter = _data.find (key);
-		if (iter != _data.end ()) {
-			callback (iter->second);
+		auto [i_begin, i_end] = _equal_range (key);
+		if (i_begin != i_end) {
+			callback (i_begin->second);
 		}
 		else {
 			std::string str;
 			callback (str);
-			_data.emplace (key, std::move (str));
+			_emplace (key, std::move (str));
 		}
 	}
 
@@ -700,6 +732,25 @@ namespace shaga {
 		return out;
 	}
 
+	void ChunkMeta::to_bin (char *const out, size_t &offset) const
+	{
+		uint16_t last_key {UINT16_MAX};
+		for (const auto &[key, value] : _data) {
+			if (last_key != key) {
+				last_key = key;
+				BIN::_be_from_uint16 (last_key, out, offset);
+			}
+			else {
+				/* Store only high 8-bit value meaning that the key is repeating */
+				BIN::_from_uint8 (key_repeat_byte, out, offset);
+			}
+
+			BIN::_from_size (value.size (), out, offset);
+			::memcpy (out + offset, value.data (), value.size ());
+			offset += value.size ();
+		}
+	}
+
 	void ChunkMeta::from_bin (const std::string_view s, size_t &offset)
 	{
 		reset ();
@@ -707,26 +758,45 @@ namespace shaga {
 		uint16_t last_key = UINT16_MAX;
 		uint16_t next_key;
 
-		while (should_continue (s, offset)) {
-			/* Read top byte first (big endian) */
-			next_key = BIN::to_uint8 (s, offset) << 8;
+		/* Entries are appended as they come and sorted once at the end, binary is sorted unless it was crafted */
+		bool sorted {true};
 
-			if (key_repeat_mask == next_key) {
-				next_key = last_key;
-			} else {
-				/* Read the rest of key, low byte */
-				next_key |= BIN::to_uint8 (s, offset);
-				last_key = next_key;
-			}
+		try {
+			while (should_continue (s, offset)) {
+				/* Read top byte first (big endian) */
+				next_key = BIN::to_uint8 (s, offset) << 8;
 
-			_check_key_validity (next_key);
+				if (key_repeat_mask == next_key) {
+					next_key = last_key;
+				} else {
+					/* Read the rest of key, low byte */
+					next_key |= BIN::to_uint8 (s, offset);
+					last_key = next_key;
+				}
 
-			const size_t len = BIN::to_size (s, offset);
-			_data.emplace (next_key, s.substr (offset, len));
-			offset += len;
-			if (offset > s.size ()) {
-				cThrow ("Not enough data in buffer"sv);
+				_check_key_validity (next_key);
+
+				if (_data.empty () == false && _data.back ().first > next_key) {
+					sorted = false;
+				}
+
+				const size_t len = BIN::to_size (s, offset);
+				_data.emplace_back (next_key, std::string (s.substr (offset, len)));
+				offset += len;
+				if (offset > s.size ()) {
+					cThrow ("Not enough data in buffer"sv);
+				}
 			}
 		}
+		catch (...) {
+			if (false == sorted) {
+				_sort_by_key (_data);
+			}
+			throw;
+		}
+
+		if (false == sorted) {
+			_sort_by_key (_data);
+		}
 	}
 }
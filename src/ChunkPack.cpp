@@ -0,0 +1,399 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#include "shaga/common.h"
+
+namespace shaga {
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  Static functions  ///////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	/* Number of bytes written by BIN::from_size () */
+	static size_t _size_bytes (const size_t sze)
+	{
+		char buf[8];
+		size_t pos {0};
+		BIN::_from_size (sze, buf, pos);
+		return pos;
+	}
+
+	/* Values are counted in small flat map, linear search is faster than hashing for a few distinct values */
+	template <class V>
+	static void _count_value (std::vector<std::pair<V, size_t>> &counts, const V &value)
+	{
+		auto iter = std::find_if (counts.begin (), counts.end (), [&value](const std::pair<V, size_t> &p) -> bool { return p.first == value; });
+		if (iter == counts.end ()) {
+			counts.emplace_back (value, 1);
+		}
+		else {
+			++(iter->second);
+		}
+	}
+
+	/* If more values are used the same number of times, the first one wins */
+	template <class V>
+	static V _most_used (const std::vector<std::pair<V, size_t>> &counts)
+	{
+		return std::max_element (counts.begin (), counts.end (), [](const std::pair<V, size_t> &a, const std::pair<V, size_t> &b) -> bool {
+			return a.second < b.second;
+		})->first;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  Batch  //////////////////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void ChunkPack::Batch::clear (void)
+	{
+		_special_types = nullptr;
+		_source = HWID_UNKNOWN;
+		_dest.reset ();
+		_records.resize (0);
+		_offsets.clear ();
+		_flags.clear ();
+	}
+
+	size_t ChunkPack::Batch::size (void) const
+	{
+		return _flags.size ();
+	}
+
+	bool ChunkPack::Batch::empty (void) const
+	{
+		return _flags.empty ();
+	}
+
+	void ChunkPack::Batch::get (const size_t pos, Chunk &out) const
+	{
+		if (pos >= _flags.size ()) {
+			cThrow ("Record {} is out of range"sv, pos);
+		}
+
+		const std::string_view record = std::string_view (_records).substr (_offsets[pos], _offsets[pos + 1] - _offsets[pos]);
+		ChunkPack::_record_from_bin (record, _flags[pos], _source, _dest, out, _special_types);
+	}
+
+	Chunk ChunkPack::Batch::get (const size_t pos) const
+	{
+		Chunk chunk;
+		get (pos, chunk);
+		return chunk;
+	}
+
+	size_t ChunkPack::Batch::get_record_size (const size_t pos) const
+	{
+		if (pos >= _flags.size ()) {
+			cThrow ("Record {} is out of range"sv, pos);
+		}
+		return _offsets[pos + 1] - _offsets[pos];
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  Private class methods  //////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	uint_fast8_t ChunkPack::_record_to_bin (const Chunk &chunk, const HWID source, const std::optional<HWIDMASK> &dest, std::string &out_append, const Chunk::SPECIAL_TYPES *const special_types)
+	{
+		uint_fast8_t flags {0};
+
+		size_t offset {0};
+		char header[8];
+		const uint32_t val = chunk._generate_header (header, offset, special_types, chunk.has_payload (), chunk.has_cbor (), false);
+		out_append.append (header, offset);
+
+		if (chunk._hwid_source != source) {
+			flags |= record_source;
+			bin_from_hwid (chunk._hwid_source, out_append);
+		}
+
+		if (Chunk::key_type_tracert == chunk._type) {
+			chunk._hops_to_bin (out_append);
+		}
+
+		if ((val & Chunk::key_has_dest_mask) && (dest.has_value () == false || (chunk._hwid_dest == *dest) == false)) {
+			flags |= record_dest;
+			bin_from_hwid (chunk._hwid_dest.mask, out_append);
+			bin_from_hwid (chunk._hwid_dest.hwid, out_append);
+		}
+
+		chunk._body_to_bin (out_append);
+
+		return flags;
+	}
+
+	void ChunkPack::_record_from_bin (const std::string_view record, const uint_fast8_t flags, const HWID source, const std::optional<HWIDMASK> &dest, Chunk &out, const Chunk::SPECIAL_TYPES *const special_types)
+	{
+		out._reset ();
+
+		size_t offset {0};
+		const uint32_t val = out._header_from_bin (record, offset, special_types);
+
+		if (flags & record_source) {
+			out._hwid_source = bin_to_hwid (record, offset);
+		}
+		else {
+			out._hwid_source = source;
+		}
+
+		if (Chunk::key_type_tracert == out._type) {
+			out._hops_from_bin (record, offset);
+		}
+
+		if (val & Chunk::key_has_dest_mask) {
+			if (flags & record_dest) {
+				out._hwid_dest.mask = bin_to_hwid (record, offset);
+				out._hwid_dest.hwid = bin_to_hwid (record, offset);
+			}
+			else if (dest.has_value () == true) {
+				out._hwid_dest = *dest;
+			}
+			else {
+				cThrow ("Destination is not defined"sv);
+			}
+		}
+
+		out._body_from_bin (record, offset, val);
+
+		if (offset != record.size ()) {
+			cThrow ("Malformed record"sv);
+		}
+	}
+
+	template <class T>
+	void ChunkPack::_to_bin (T &lst_erase, std::string &out_append, const size_t max_size, const Chunk::Priority max_priority, const bool erase_skipped)
+	{
+		/* The most used source and destination, batches usually contain just a few distinct values */
+		std::vector<std::pair<HWID, size_t>> sources;
+		std::vector<std::pair<HWIDMASK, size_t>> dests;
+
+		for (const Chunk &chunk : lst_erase) {
+			if (chunk._prio > max_priority) {
+				continue;
+			}
+			_count_value (sources, chunk._hwid_source);
+			if (chunk._hwid_dest.empty () == false) {
+				_count_value (dests, chunk._hwid_dest);
+			}
+		}
+
+		const HWID source = sources.empty () ? HWID_UNKNOWN : _most_used (sources);
+		std::optional<HWIDMASK> common_dest;
+		if (dests.empty () == false) {
+			common_dest = _most_used (dests);
+		}
+
+		/* Batch without index and records, number of records is added when it is known */
+		const size_t head_size = sizeof (uint8_t) + sizeof (HWID) + (common_dest.has_value () ? (2 * sizeof (HWID)) : 0);
+		size_t index_size {0};
+
+		_records.resize (0);
+		_index.clear ();
+
+		/* List is not modified until the batch is written, so exception leaves it untouched */
+		typename T::iterator iter = lst_erase.begin ();
+		for (; iter != lst_erase.end (); ++iter) {
+			if (iter->_prio > max_priority) {
+				continue;
+			}
+
+			const size_t start = _records.size ();
+			const uint_fast8_t flags = _record_to_bin (*iter, source, common_dest, _records, _special_types);
+			const size_t entry = ((_records.size () - start) << 2) | flags;
+
+			/* Size is checked without compression, compressed frame is used only if it is smaller */
+			if (max_size > 0 && (head_size + _size_bytes (_index.size () + 1) + index_size + _size_bytes (entry) + _records.size ()) > max_size) {
+				_records.resize (start);
+				if (_index.empty () == true) {
+					cThrow ("Unable to add first chunk."sv);
+				}
+				break;
+			}
+
+			index_size += _size_bytes (entry);
+			_index.push_back (entry);
+		}
+
+		uint8_t batch_flags = version << 4;
+
+		bool use_frame {false};
+		if (true == _compress && _records.size () >= LZ::min_compress_size) {
+			_frame.resize (0);
+			_compressor.compress (_records, _frame);
+			use_frame = (static_cast<uint8_t> (_frame[0]) == LZ::frame_compressed) && (_size_bytes (_frame.size ()) + _frame.size ()) < _records.size ();
+		}
+
+		if (true == use_frame) {
+			batch_flags |= flag_compressed;
+		}
+		if (common_dest.has_value () == true) {
+			batch_flags |= flag_common_dest;
+		}
+
+		BIN::from_uint8 (batch_flags, out_append);
+		BIN::from_size (_index.size (), out_append);
+		bin_from_hwid (source, out_append);
+		if (common_dest.has_value () == true) {
+			bin_from_hwid (common_dest->mask, out_append);
+			bin_from_hwid (common_dest->hwid, out_append);
+		}
+
+		for (const size_t entry : _index) {
+			BIN::from_size (entry, out_append);
+		}
+
+		if (true == use_frame) {
+			BIN::from_size (_frame.size (), out_append);
+			out_append.append (_frame);
+		}
+		else {
+			out_append.append (_records);
+		}
+
+		/* Packed chunks are erased, skipped ones are compacted to the front unless they should be erased too */
+		typename T::iterator write = lst_erase.begin ();
+		for (typename T::iterator it = lst_erase.begin (); it != iter; ++it) {
+			if (it->_prio > max_priority && false == erase_skipped) {
+				if (write != it) {
+					*write = std::move (*it);
+				}
+				++write;
+			}
+		}
+		lst_erase.erase (write, iter);
+	}
+
+	template <class T>
+	void ChunkPack::_from_bin (const std::string_view buf, size_t &offset, T &out_append) const
+	{
+		Batch batch;
+		size_t pos {offset};
+		decode (buf, pos, batch);
+
+		/* Chunks are appended only if all of them were decoded */
+		T tmp;
+		for (size_t i = 0; i < batch.size (); ++i) {
+			batch.get (i, tmp.emplace_back ());
+		}
+
+		for (auto &chunk : tmp) {
+			out_append.push_back (std::move (chunk));
+		}
+		offset = pos;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  Public class methods  ///////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	ChunkPack::ChunkPack (const bool compress, const Chunk::SPECIAL_TYPES *const special_types) :
+		_special_types (special_types),
+		_compress (compress)
+	{}
+
+	void ChunkPack::to_bin (CHUNKLIST &lst_erase, std::string &out_append, const size_t max_size, const Chunk::Priority max_priority, const bool erase_skipped)
+	{
+		_to_bin (lst_erase, out_append, max_size, max_priority, erase_skipped);
+	}
+
+	std::string ChunkPack::to_bin (CHUNKLIST &lst_erase, const size_t max_size, const Chunk::Priority max_priority, const bool erase_skipped)
+	{
+		std::string out;
+		_to_bin (lst_erase, out, max_size, max_priority, erase_skipped);
+		return out;
+	}
+
+	void ChunkPack::to_bin (CHUNKDEQUE &lst_erase, std::string &out_append, const size_t max_size, const Chunk::Priority max_priority, const bool erase_skipped)
+	{
+		_to_bin (lst_erase, out_append, max_size, max_priority, erase_skipped);
+	}
+
+	std::string ChunkPack::to_bin (CHUNKDEQUE &lst_erase, const size_t max_size, const Chunk::Priority max_priority, const bool erase_skipped)
+	{
+		std::string out;
+		_to_bin (lst_erase, out, max_size, max_priority, erase_skipped);
+		return out;
+	}
+
+	void ChunkPack::decode (const std::string_view buf, size_t &offset, Batch &out) const
+	{
+		out.clear ();
+
+		try {
+			size_t pos {offset};
+
+			const uint8_t flags = BIN::to_uint8 (buf, pos);
+			if ((flags >> 4) != version) {
+				cThrow ("Unsupported batch version {}"sv, flags >> 4);
+			}
+
+			const size_t count = BIN::to_size (buf, pos);
+			/* Every index entry takes at least one byte */
+			if (pos > buf.size () || count > (buf.size () - pos)) {
+				cThrow ("Not enough data in buffer"sv);
+			}
+
+			out._source = bin_to_hwid (buf, pos);
+			if (flags & flag_common_dest) {
+				HWIDMASK dest;
+				dest.mask = bin_to_hwid (buf, pos);
+				dest.hwid = bin_to_hwid (buf, pos);
+				out._dest = dest;
+			}
+
+			out._offsets.reserve (count + 1);
+			out._flags.reserve (count);
+			out._offsets.push_back (0);
+
+			for (size_t i = 0; i < count; ++i) {
+				const size_t entry = BIN::to_size (buf, pos);
+				out._flags.push_back (static_cast<uint8_t> (entry & (record_source | record_dest)));
+				out._offsets.push_back (out._offsets.back () + (entry >> 2));
+			}
+
+			if (flags & flag_compressed) {
+				const size_t len = BIN::to_size (buf, pos);
+				if ((pos + len) > buf.size ()) {
+					cThrow ("Not enough data in buffer"sv);
+				}
+
+				LZ::Decompressor decompressor (false);
+				decompressor.decompress (buf.substr (pos, len), out._records);
+				pos += len;
+			}
+			else {
+				const size_t len = out._offsets.back ();
+				if ((pos + len) > buf.size ()) {
+					cThrow ("Not enough data in buffer"sv);
+				}
+
+				out._records.assign (buf.substr (pos, len));
+				pos += len;
+			}
+
+			if (out._records.size () != out._offsets.back ()) {
+				cThrow ("Size mismatch"sv);
+			}
+
+			out._special_types = _special_types;
+			offset = pos;
+		}
+		catch (...) {
+			out.clear ();
+			throw;
+		}
+	}
+
+	void ChunkPack::from_bin (const std::string_view buf, size_t &offset, CHUNKLIST &out_append) const
+	{
+		_from_bin (buf, offset, out_append);
+	}
+
+	void ChunkPack::from_bin (const std::string_view buf, size_t &offset, CHUNKDEQUE &out_append) const
+	{
+		_from_bin (buf, offset, out_append);
+	}
+}
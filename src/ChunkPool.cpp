@@ -0,0 +1,153 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#include "shaga/common.h"
+
+namespace shaga {
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  Storage  ////////////////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	struct ChunkPool::_Storage {
+		const size_t max_size;
+		const size_t max_chunk_bytes;
+
+		#ifdef SHAGA_THREADING
+			mutable std::mutex mutex;
+		#endif // SHAGA_THREADING
+
+		std::vector<std::unique_ptr<Chunk>> free;
+		size_t allocations {0};
+
+		_Storage (const size_t _max_size, const size_t _max_chunk_bytes) :
+			max_size (_max_size),
+			max_chunk_bytes (_max_chunk_bytes)
+		{
+			free.reserve (max_size);
+		}
+
+		void release (std::unique_ptr<Chunk> chunk)
+		{
+			if (max_chunk_bytes > 0 && chunk->_get_capacity () > max_chunk_bytes) {
+				return;
+			}
+
+			#ifdef SHAGA_THREADING
+				std::lock_guard<std::mutex> lock (mutex);
+			#endif // SHAGA_THREADING
+
+			if (free.size () < max_size) {
+				free.push_back (std::move (chunk));
+			}
+		}
+	};
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  Deleter  ////////////////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	ChunkPool::Deleter::Deleter (const std::shared_ptr<_Storage> &storage) :
+		_storage (storage)
+	{}
+
+	void ChunkPool::Deleter::operator() (Chunk *const chunk) const
+	{
+		std::unique_ptr<Chunk> ptr (chunk);
+		if (nullptr != _storage) {
+			_storage->release (std::move (ptr));
+		}
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  Private class methods  //////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	Chunk * ChunkPool::_acquire (void)
+	{
+		{
+			#ifdef SHAGA_THREADING
+				std::lock_guard<std::mutex> lock (_storage->mutex);
+			#endif // SHAGA_THREADING
+
+			if (_storage->free.empty () == false) {
+				Chunk *const chunk = _storage->free.back ().release ();
+				_storage->free.pop_back ();
+				return chunk;
+			}
+
+			++_storage->allocations;
+		}
+
+		return new Chunk ();
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  Public class methods  ///////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	ChunkPool::ChunkPool (const size_t max_size, const size_t max_chunk_bytes) :
+		_storage (std::make_shared<_Storage> (max_size, max_chunk_bytes))
+	{}
+
+	ChunkPool::Handle ChunkPool::get (const HWID hwid_source, const std::string_view type)
+	{
+		Handle chunk (_acquire (), Deleter (_storage));
+		chunk->reset (hwid_source, type);
+		return chunk;
+	}
+
+	ChunkPool::Handle ChunkPool::get (const HWID hwid_source, const uint32_t type)
+	{
+		Handle chunk (_acquire (), Deleter (_storage));
+		chunk->reset (hwid_source, type);
+		return chunk;
+	}
+
+	ChunkPool::Handle ChunkPool::get (const std::string_view bin, size_t &offset, const Chunk::SPECIAL_TYPES *const special_types, const bool store_binary_representation)
+	{
+		Handle chunk (_acquire (), Deleter (_storage));
+		chunk->from_bin (bin, offset, special_types, store_binary_representation);
+		return chunk;
+	}
+
+	void ChunkPool::recycle (Chunk &&chunk)
+	{
+		/* Only the chunk object is allocated, its containers are moved */
+		_storage->release (std::make_unique<Chunk> (std::move (chunk)));
+	}
+
+	size_t ChunkPool::size (void) const
+	{
+		#ifdef SHAGA_THREADING
+			std::lock_guard<std::mutex> lock (_storage->mutex);
+		#endif // SHAGA_THREADING
+
+		return _storage->free.size ();
+	}
+
+	size_t ChunkPool::get_allocations (void) const
+	{
+		#ifdef SHAGA_THREADING
+			std::lock_guard<std::mutex> lock (_storage->mutex);
+		#endif // SHAGA_THREADING
+
+		return _storage->allocations;
+	}
+
+	void ChunkPool::clear (void)
+	{
+		std::vector<std::unique_ptr<Chunk>> tmp;
+		{
+			#ifdef SHAGA_THREADING
+				std::lock_guard<std::mutex> lock (_storage->mutex);
+			#endif // SHAGA_THREADING
+
+			tmp.swap (_storage->free);
+			_storage->free.reserve (_storage->max_size);
+		}
+	}
+}
@@ -0,0 +1,61 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#include "shaga/common.h"
+
+namespace shaga {
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  Private class methods  //////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	size_t ChunkPrioQueue::_first_bucket (void) const
+	{
+		if (0 == _size) {
+			cThrow ("Queue is empty"sv);
+		}
+
+		for (size_t idx = 0; idx < num_buckets; ++idx) {
+			if (_buckets[idx].empty () == false) {
+				return idx;
+			}
+		}
+
+		cThrow ("Queue is corrupted"sv);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  Public class methods  ///////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void ChunkPrioQueue::push (const Chunk &chunk)
+	{
+		_buckets[_bucket_index (chunk.get_prio ())].push_back (chunk);
+		++_size;
+	}
+
+	void ChunkPrioQueue::push (Chunk &&chunk)
+	{
+		_buckets[_bucket_index (chunk.get_prio ())].push_back (std::move (chunk));
+		++_size;
+	}
+
+	const Chunk & ChunkPrioQueue::front (void) const
+	{
+		return _buckets[_first_bucket ()].front ();
+	}
+
+	Chunk & ChunkPrioQueue::front (void)
+	{
+		return _buckets[_first_bucket ()].front ();
+	}
+
+	void ChunkPrioQueue::pop_front (void)
+	{
+		_buckets[_first_bucket ()].pop_front ();
+		--_size;
+	}
+}
@@ -0,0 +1,33 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#include "shaga/common.h"
+
+namespace shaga {
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  Public class methods  ///////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void ChunkPrioSet::insert (const Chunk &chunk)
+	{
+		insert (Chunk (chunk));
+	}
+
+	void ChunkPrioSet::insert (Chunk &&chunk)
+	{
+		auto &bucket = _buckets[_bucket_index (chunk.get_prio ())];
+
+		if (bucket.empty () == true || (chunk < bucket.back ()) == false) {
+			bucket.push_back (std::move (chunk));
+		}
+		else {
+			/* Upper bound, so equal chunks keep order of insertion just like in std::multiset */
+			bucket.insert (std::upper_bound (bucket.begin (), bucket.end (), chunk), std::move (chunk));
+		}
+		++_size;
+	}
+}
@@ -0,0 +1,245 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#include "shaga/common.h"
+
+namespace shaga {
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  Body  ///////////////////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	struct ChunkShared::_Body {
+		/* Serialized payload, CBOR and meta, payload and CBOR are referenced from here */
+		std::string bin;
+		size_t payload_offset {0};
+		size_t payload_size {0};
+		size_t cbor_offset {0};
+		size_t cbor_size {0};
+		ChunkMeta meta;
+
+		_Body (Chunk &chunk)
+		{
+			chunk._body_to_bin (bin);
+
+			size_t offset {0};
+			if (chunk.has_payload () == true) {
+				payload_size = BIN::to_size (bin, offset);
+				payload_offset = offset;
+				offset += payload_size;
+			}
+			if (chunk.has_cbor () == true) {
+				cbor_size = BIN::to_size (bin, offset);
+				cbor_offset = offset;
+				offset += cbor_size;
+			}
+
+			meta = std::move (chunk.meta);
+		}
+	};
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  Public class methods  ///////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	ChunkShared::ChunkShared (const Chunk &chunk) :
+		ChunkShared (Chunk (chunk))
+	{}
+
+	ChunkShared::ChunkShared (Chunk &&chunk) :
+		_header (std::move (chunk))
+	{
+		_body = std::make_shared<const _Body> (_header);
+
+		_header._payload.clear ();
+		_header._payload.shrink_to_fit ();
+		_header._cbor.clear ();
+		_header._cbor.shrink_to_fit ();
+		_header.meta.clear ();
+		_header.invalidate_stored_binary_representation ();
+	}
+
+	Chunk ChunkShared::to_chunk (void) const
+	{
+		Chunk chunk (_header);
+		chunk._payload.assign (get_payload ());
+		const std::string_view cbor = get_cbor ();
+		chunk._cbor.assign (cbor.begin (), cbor.end ());
+		chunk.meta = _body->meta;
+		return chunk;
+	}
+
+	long ChunkShared::use_count (void) const
+	{
+		return _body.use_count ();
+	}
+
+	void ChunkShared::set_channel (const bool is_primary)
+	{
+		_header.set_channel (is_primary);
+	}
+
+	bool ChunkShared::is_primary_channel (void) const
+	{
+		return _header.is_primary_channel ();
+	}
+
+	HWID ChunkShared::get_source_hwid (void) const
+	{
+		return _header.get_source_hwid ();
+	}
+
+	std::string ChunkShared::get_type (void) const
+	{
+		return _header.get_type ();
+	}
+
+	uint32_t ChunkShared::get_num_type (void) const
+	{
+		return _header.get_num_type ();
+	}
+
+	void ChunkShared::set_prio (const Chunk::Priority prio)
+	{
+		_header.set_prio (prio);
+	}
+
+	Chunk::Priority ChunkShared::get_prio (void) const
+	{
+		return _header.get_prio ();
+	}
+
+	void ChunkShared::set_minimal_trustlevel (const Chunk::TrustLevel trust)
+	{
+		_header.set_minimal_trustlevel (trust);
+	}
+
+	void ChunkShared::set_trustlevel (const Chunk::TrustLevel trust)
+	{
+		_header.set_trustlevel (trust);
+	}
+
+	Chunk::TrustLevel ChunkShared::get_trustlevel (void) const
+	{
+		return _header.get_trustlevel ();
+	}
+
+	void ChunkShared::set_ttl (const uint8_t ttl)
+	{
+		_header.set_ttl (ttl);
+	}
+
+	void ChunkShared::set_ttl (const Chunk::TTL ttl)
+	{
+		_header.set_ttl (ttl);
+	}
+
+	uint8_t ChunkShared::get_ttl (void) const
+	{
+		return _header.get_ttl ();
+	}
+
+	bool ChunkShared::is_zero_ttl (void) const
+	{
+		return _header.is_zero_ttl ();
+	}
+
+	bool ChunkShared::hop_ttl (void)
+	{
+		return _header.hop_ttl ();
+	}
+
+	bool ChunkShared::tracert_hops_add (const shaga::HWID hwid, const uint8_t metric)
+	{
+		return _header.tracert_hops_add (hwid, metric);
+	}
+
+	Chunk::TracertHops ChunkShared::tracert_hops_get (void) const
+	{
+		return _header.tracert_hops_get ();
+	}
+
+	HWIDMASK ChunkShared::get_destination_hwidmask (void) const
+	{
+		return _header.get_destination_hwidmask ();
+	}
+
+	void ChunkShared::set_destination_hwid (const HWID hwid)
+	{
+		_header.set_destination_hwid (hwid);
+	}
+
+	void ChunkShared::set_destination_hwid (const HWIDMASK &hwidmask)
+	{
+		_header.set_destination_hwid (hwidmask);
+	}
+
+	void ChunkShared::set_destination_broadcast (void)
+	{
+		_header.set_destination_broadcast ();
+	}
+
+	bool ChunkShared::is_for_destination (const HWID hwid) const
+	{
+		return _header.is_for_destination (hwid);
+	}
+
+	bool ChunkShared::has_payload (void) const
+	{
+		return _body->payload_size > 0;
+	}
+
+	SHAGA_STRV std::string_view ChunkShared::get_payload (void) const
+	{
+		return std::string_view (_body->bin).substr (_body->payload_offset, _body->payload_size);
+	}
+
+	bool ChunkShared::has_cbor (void) const
+	{
+		return _body->cbor_size > 0;
+	}
+
+	SHAGA_STRV std::string_view ChunkShared::get_cbor (void) const
+	{
+		return std::string_view (_body->bin).substr (_body->cbor_offset, _body->cbor_size);
+	}
+
+	CBOR::Reader ChunkShared::get_cbor_reader (void) const
+	{
+		return CBOR::Reader (get_cbor ());
+	}
+
+	nlohmann::json ChunkShared::get_json (void) const
+	{
+		const std::string_view cbor = get_cbor ();
+		return nlohmann::json::from_cbor (cbor.begin (), cbor.end ());
+	}
+
+	const ChunkMeta & ChunkShared::get_meta (void) const
+	{
+		return _body->meta;
+	}
+
+	size_t ChunkShared::get_max_bytes (void) const
+	{
+		/* Header part of Chunk::get_max_bytes (), payload, CBOR and meta are already serialized */
+		return _header.get_max_bytes () + _body->bin.size ();
+	}
+
+	void ChunkShared::to_bin (std::string &out_append, const Chunk::SPECIAL_TYPES *const special_types) const
+	{
+		_header._head_to_bin (out_append, special_types, has_payload (), has_cbor ());
+		out_append.append (_body->bin);
+	}
+
+	std::string ChunkShared::to_bin (const Chunk::SPECIAL_TYPES *const special_types) const
+	{
+		std::string out;
+		out.reserve (get_max_bytes ());
+		to_bin (out, special_types);
+		return out;
+	}
+}
@@ -0,0 +1,226 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#include "shaga/common.h"
+
+namespace shaga {
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  Static functions  ///////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	/* Epoch followed by all entries of the table, unused entries are zero */
+	static const constexpr size_t _chunkspecialtypes_payload_size {sizeof (uint32_t) * (1 + Chunk::num_special_types)};
+
+	static bool _chunkspecialtypes_allowed (const uint32_t type)
+	{
+		return type >= Chunk::key_type_min && type <= Chunk::key_type_max
+			&& type != Chunk::key_type_tracert && type != ChunkSpecialTypes::key_type_control;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  Private class methods  //////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	bool ChunkSpecialTypes::_apply (const uint32_t type, const std::string_view payload)
+	{
+		if (key_type_control != type) {
+			return false;
+		}
+
+		if (payload.size () != _chunkspecialtypes_payload_size) {
+			cThrow ("Special types control chunk has wrong size {}"sv, payload.size ());
+		}
+
+		size_t offset {0};
+		const uint32_t epoch = BIN::to_uint32 (payload, offset);
+		if (epoch != static_cast<uint32_t> (_epoch + 1)) {
+			cThrow ("Special types epoch mismatch, expected {}, received {}"sv, static_cast<uint32_t> (_epoch + 1), epoch);
+		}
+
+		Chunk::SPECIAL_TYPES table {};
+		for (size_t i = 0; i < table.size (); ++i) {
+			table[i] = BIN::to_uint32 (payload, offset);
+			if (0 == table[i]) {
+				continue;
+			}
+			if (_chunkspecialtypes_allowed (table[i]) == false) {
+				cThrow ("Special types control chunk contains invalid type {:X}"sv, table[i]);
+			}
+			if (std::find (table.cbegin (), table.cbegin () + i, table[i]) != table.cbegin () + i) {
+				cThrow ("Special types control chunk contains duplicate type {}"sv, Chunk::bin_to_key (table[i]));
+			}
+		}
+
+		_table = table;
+		_epoch = epoch;
+		return true;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  Public class methods  ///////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	ChunkSpecialTypes::ChunkSpecialTypes (const uint64_t min_gain) :
+		_min_gain (min_gain)
+	{}
+
+	ChunkSpecialTypes::ChunkSpecialTypes (const Chunk::SPECIAL_TYPES &initial_table, const uint64_t min_gain) :
+		_table (initial_table),
+		_min_gain (min_gain)
+	{
+		for (const auto type : _table) {
+			if (0 != type && _chunkspecialtypes_allowed (type) == false) {
+				cThrow ("Invalid special type {:X}"sv, type);
+			}
+		}
+	}
+
+	const Chunk::SPECIAL_TYPES * ChunkSpecialTypes::get (void) const
+	{
+		return &_table;
+	}
+
+	uint32_t ChunkSpecialTypes::get_epoch (void) const
+	{
+		return _epoch;
+	}
+
+	void ChunkSpecialTypes::count (const uint32_t type, const uint64_t cnt)
+	{
+		if (_chunkspecialtypes_allowed (type) == true) {
+			_counts[type] += cnt;
+		}
+	}
+
+	void ChunkSpecialTypes::count (const Chunk &chunk)
+	{
+		count (chunk.get_num_type ());
+	}
+
+	bool ChunkSpecialTypes::propose (const HWID hwid_source)
+	{
+		std::vector<std::pair<uint64_t, uint32_t>> freq;
+		freq.reserve (_counts.size ());
+		for (const auto &[type, cnt] : _counts) {
+			freq.emplace_back (cnt, type);
+		}
+
+		/* Most frequent first, ties are broken by type so the result is deterministic */
+		const size_t top = std::min (freq.size (), _table.size ());
+		std::partial_sort (freq.begin (), freq.begin () + top, freq.end (), [](const auto &a, const auto &b) -> bool {
+			return (a.first != b.first) ? (a.first > b.first) : (a.second < b.second);
+		});
+
+		/* Compare with the table that will be used, pending one is not committed yet */
+		const Chunk::SPECIAL_TYPES &current = _pending.has_value () ? _pending_table : _table;
+
+		uint64_t gain_current {0};
+		for (const auto type : current) {
+			if (auto iter = _counts.find (type); iter != _counts.end ()) {
+				gain_current += iter->second;
+			}
+		}
+
+		uint64_t gain_new {0};
+		for (size_t i = 0; i < top; ++i) {
+			gain_new += freq[i].first;
+		}
+
+		/* Halve counts and drop types that are not used anymore */
+		for (auto iter = _counts.begin (); iter != _counts.end ();) {
+			iter->second >>= 1;
+			if (0 == iter->second) {
+				iter = _counts.erase (iter);
+			}
+			else {
+				++iter;
+			}
+		}
+
+		/* Every chunk of special type saves 2 bytes of header */
+		if (gain_new <= gain_current || ((gain_new - gain_current) * 2) < _min_gain) {
+			return _pending.has_value ();
+		}
+
+		/* Types that stay in the table keep their position */
+		Chunk::SPECIAL_TYPES table {};
+		std::vector<uint32_t> added;
+		for (size_t i = 0; i < top; ++i) {
+			const auto iter = std::find (current.cbegin (), current.cend (), freq[i].second);
+			if (iter != current.cend ()) {
+				table[std::distance (current.cbegin (), iter)] = freq[i].second;
+			}
+			else {
+				added.push_back (freq[i].second);
+			}
+		}
+		auto added_iter = added.cbegin ();
+		for (auto &type : table) {
+			if (0 == type && added_iter != added.cend ()) {
+				type = *added_iter++;
+			}
+		}
+
+		std::string payload;
+		payload.reserve (_chunkspecialtypes_payload_size);
+		BIN::from_uint32 (static_cast<uint32_t> (_epoch + 1), payload);
+		for (const auto type : table) {
+			BIN::from_uint32 (static_cast<uint32_t> (type), payload);
+		}
+
+		/* Control chunk is meant only for the peer on this link */
+		_pending.emplace (hwid_source, key_type_control, Chunk::Priority::pCRITICAL);
+		_pending->set_ttl (0);
+		_pending->set_payload (std::move (payload));
+		_pending_table = table;
+		return true;
+	}
+
+	bool ChunkSpecialTypes::is_pending (void) const
+	{
+		return _pending.has_value ();
+	}
+
+	bool ChunkSpecialTypes::commit (std::string &out_append)
+	{
+		if (_pending.has_value () == false) {
+			return false;
+		}
+
+		_pending->to_bin (out_append, &_table);
+		_table = _pending_table;
+		++_epoch;
+		_pending.reset ();
+		return true;
+	}
+
+	void ChunkSpecialTypes::to_bin (const Chunk &chunk, std::string &out_append)
+	{
+		commit (out_append);
+		chunk.to_bin (out_append, &_table);
+	}
+
+	bool ChunkSpecialTypes::apply (const Chunk &chunk)
+	{
+		return _apply (chunk.get_num_type (), chunk.get_payload ());
+	}
+
+	bool ChunkSpecialTypes::apply (const ChunkView &view)
+	{
+		return _apply (view.get_num_type (), view.get_payload ());
+	}
+
+	void ChunkSpecialTypes::from_bin (const std::string_view buf, size_t &offset, CHUNKLIST &out_append)
+	{
+		while (offset < buf.size ()) {
+			Chunk chunk (buf, offset, &_table);
+			if (_apply (chunk.get_num_type (), chunk.get_payload ()) == false) {
+				out_append.push_back (std::move (chunk));
+			}
+		}
+	}
+}
@@ -16,6 +16,194 @@ namespace shaga {
 	//  Private class methods  //////////////////////////////////////////////////////////////////////////////////////
 	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+	bool ChunkTool::_append_chunk (const Chunk &chunk, std::string &out_append, const size_t start_size, const size_t max_size) const
+	{
+		/* Chunk is serialized directly to the output, if it doesn't fit, it is truncated back */
+		const size_t chunk_start = out_append.size ();
+		out_append.reserve (chunk_start + chunk.get_max_bytes ());
+
+		try {
+			chunk.to_bin (out_append, _special_types);
+		}
+		catch (...) {
+			out_append.resize (chunk_start);
+			throw;
+		}
+
+		if (max_size > 0 && (out_append.size () - start_size) > max_size) {
+			out_append.resize (chunk_start);
+			return false;
+		}
+
+		return true;
+	}
+
+	template <class T>
+	void ChunkTool::_to_bin_buckets (T &cs_erase, std::string &out_append, const size_t max_size, const Chunk::Priority max_priority)
+	{
+		const size_t start_size = out_append.size ();
+		size_t cnt = 0;
+
+		for (size_t idx = 0; idx < T::num_buckets; ++idx) {
+			const Chunk::Priority prio = uint8_to_priority (static_cast<uint8_t> (idx));
+			if (prio > max_priority) {
+				break;
+			}
+
+			/* Whole processed part of the bucket is erased at once */
+			size_t done = 0;
+			bool full = false;
+			try {
+				for (const Chunk &chunk : cs_erase.bucket (prio)) {
+					if (_append_chunk (chunk, out_append, start_size, max_size) == false) {
+						full = true;
+						break;
+					}
+
+					++done;
+					++cnt;
+				}
+			}
+			catch (...) {
+				/* Chunks already written to the output must not stay in the bucket */
+				cs_erase.erase_front (prio, done);
+				throw;
+			}
+
+			cs_erase.erase_front (prio, done);
+
+			if (true == full) {
+				if (true == _enable_thr) {
+					if (0 == cnt) {
+						cThrow ("Unable to add first chunk."sv);
+					}
+					if (prio == Chunk::Priority::pCRITICAL || prio == Chunk::Priority::pMANDATORY) {
+						cThrow ("Unable to add critical and mandatory chunks. Buffer is full."sv);
+					}
+				}
+				return;
+			}
+		}
+	}
+
+	template <class T>
+	void ChunkTool::_trim_buckets (T &cset, const size_t treshold_size, const Chunk::Priority treshold_prio)
+	{
+		size_t sze = cset.size ();
+
+		/* Drop chunks from the lowest priority bucket, whole buckets at once if possible */
+		for (size_t idx = T::num_buckets; idx > 0 && sze > treshold_size; --idx) {
+			const Chunk::Priority prio = uint8_to_priority (static_cast<uint8_t> (idx - 1));
+			if (prio < treshold_prio) {
+				break;
+			}
+
+			const size_t bucket_size = cset.bucket_size (prio);
+			const size_t drop = std::min (bucket_size, sze - treshold_size);
+
+			cset.truncate (prio, bucket_size - drop);
+			sze -= drop;
+		}
+	}
+
+	template <class T>
+	void ChunkTool::_from_bin_parallel (const std::string_view buf, size_t &offset, T &out_append, const size_t max_threads) const
+	{
+		/* Phase 1: find where chunks start, views only walk the structure */
+		std::vector<size_t> starts;
+		size_t end_offset {offset};
+		while (end_offset != buf.size ()) {
+			starts.push_back (end_offset);
+			ChunkView (buf, end_offset, _special_types);
+		}
+
+		const size_t cnt = starts.size ();
+		if (0 == cnt) {
+			return;
+		}
+
+		/* Phase 2: decode in place into pre-sized output, every thread writes its own range. Counters are reserved
+		 * at once and follow order in buffer, exactly like with sequential decoding. */
+		const uint_fast64_t counter = Chunk::_reserve_counters (cnt);
+		const size_t first = out_append.size ();
+
+		try {
+			for (size_t i = 0; i < cnt; ++i) {
+				out_append.push_back (Chunk (Chunk::_KeepCounter (), counter + i));
+			}
+		}
+		catch (...) {
+			out_append.erase (out_append.begin () + first, out_append.end ());
+			throw;
+		}
+
+		auto decode_range = [&](const size_t from, const size_t to) -> void {
+			for (size_t i = from; i < to; ++i) {
+				size_t pos = starts[i];
+				out_append[first + i]._from_bin (buf, pos, _special_types, _store_binary);
+			}
+		};
+
+		try {
+			#ifdef SHAGA_THREADING
+				size_t threads = (0 == max_threads) ? std::thread::hardware_concurrency () : max_threads;
+				threads = std::max<size_t> (1, std::min (threads, cnt / parallel_min_chunks));
+
+				if (threads > 1) {
+					const size_t per_thread = (cnt + threads - 1) / threads;
+					std::vector<std::exception_ptr> errors (threads);
+					std::vector<std::thread> workers;
+					workers.reserve (threads - 1);
+
+					auto worker = [&](const size_t id) -> void {
+						try {
+							decode_range (id * per_thread, std::min (cnt, (id + 1) * per_thread));
+						}
+						catch (...) {
+							errors[id] = std::current_exception ();
+						}
+					};
+
+					try {
+						for (size_t id = 1; id < threads; ++id) {
+							workers.emplace_back (worker, id);
+						}
+					}
+					catch (...) {
+						for (auto &thr : workers) {
+							thr.join ();
+						}
+						throw;
+					}
+
+					worker (0);
+
+					for (auto &thr : workers) {
+						thr.join ();
+					}
+
+					for (const auto &err : errors) {
+						if (err) {
+							std::rethrow_exception (err);
+						}
+					}
+				}
+				else {
+					decode_range (0, cnt);
+				}
+			#else
+				(void) max_threads;
+				decode_range (0, cnt);
+			#endif // SHAGA_THREADING
+		}
+		catch (...) {
+			out_append.erase (out_append.begin () + first, out_append.end ());
+			throw;
+		}
+
+		offset = end_offset;
+	}
+
 	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	//  Public class methods  ///////////////////////////////////////////////////////////////////////////////////////
 	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -54,10 +242,58 @@ namespace shaga {
 		}
 	}
 
+	void ChunkTool::from_bin (const std::string_view buf, size_t &offset, CHUNKDEQUE &out_append) const
+	{
+		while (offset != buf.size ()) {
+			out_append.emplace_back (buf, offset, _special_types, _store_binary);
+		}
+	}
+
+	void ChunkTool::from_bin (const std::string_view buf, size_t &offset, ChunkPrioSet &out_append) const
+	{
+		while (offset != buf.size ()) {
+			out_append.emplace (buf, offset, _special_types, _store_binary);
+		}
+	}
+
+	void ChunkTool::from_bin (const std::string_view buf, size_t &offset, ChunkPrioQueue &out_append) const
+	{
+		while (offset != buf.size ()) {
+			out_append.emplace (buf, offset, _special_types, _store_binary);
+		}
+	}
+
+	void ChunkTool::from_bin (const std::string_view buf, size_t &offset, CHUNKVIEWS &out_append) const
+	{
+		while (offset != buf.size ()) {
+			out_append.emplace_back (buf, offset, _special_types);
+		}
+	}
+
+	void ChunkTool::from_bin_parallel (const std::string_view buf, size_t &offset, std::vector<Chunk> &out_append, const size_t max_threads) const
+	{
+		_from_bin_parallel (buf, offset, out_append, max_threads);
+	}
+
+	void ChunkTool::from_bin_parallel (const std::string_view buf, size_t &offset, CHUNKDEQUE &out_append, const size_t max_threads) const
+	{
+		_from_bin_parallel (buf, offset, out_append, max_threads);
+	}
+
+	void ChunkTool::from_bin (const std::string_view buf, ChunkBatch &out) const
+	{
+		out.decode (buf, _special_types);
+	}
+
+	void ChunkTool::from_bin (std::string &&buf, ChunkBatch &out) const
+	{
+		out.decode (std::move (buf), _special_types);
+	}
+
 	/*** To binary string ***/
 	void ChunkTool::to_bin (CHUNKLIST &lst_erase, std::string &out_append, const size_t max_size, const Chunk::Priority max_priority, const bool erase_skipped)
 	{
-		size_t sze = 0;
+		const size_t start_size = out_append.size ();
 		size_t cnt = 0;
 
 		for (CHUNKLIST::iterator iter = lst_erase.begin (); iter != lst_erase.end ();) {
@@ -71,9 +307,7 @@ namespace shaga {
 				continue;
 			}
 
-			_temp_str.resize (0);
-			iter->to_bin (_temp_str, _special_types);
-			if (max_size > 0 && (_temp_str.size () + sze) > max_size) {
+			if (_append_chunk (*iter, out_append, start_size, max_size) == false) {
 				if (true == _enable_thr) {
 					if (cnt == 0) {
 						cThrow ("Unable to add first chunk."sv);
@@ -82,9 +316,6 @@ namespace shaga {
 				break;
 			}
 
-			out_append.append (_temp_str);
-			sze += _temp_str.size ();
-
 			iter = lst_erase.erase (iter);
 			++cnt;
 		}
@@ -99,7 +330,7 @@ namespace shaga {
 
 	void ChunkTool::to_bin (CHUNKSET &cs_erase, std::string &out_append, const size_t max_size, const Chunk::Priority max_priority)
 	{
-		size_t sze = 0;
+		const size_t start_size = out_append.size ();
 		size_t cnt = 0;
 
 		for (CHUNKSET::iterator iter = cs_erase.begin (); iter != cs_erase.end ();) {
@@ -107,9 +338,7 @@ namespace shaga {
 				break;
 			}
 
-			_temp_str.resize (0);
-			iter->to_bin (_temp_str, _special_types);
-			if (max_size > 0 && (_temp_str.size () + sze) > max_size) {
+			if (_append_chunk (*iter, out_append, start_size, max_size) == false) {
 				if (true == _enable_thr) {
 					if (0 == cnt) {
 						cThrow ("Unable to add first chunk."sv);
@@ -121,9 +350,6 @@ namespace shaga {
 				break;
 			}
 
-			out_append.append (_temp_str);
-			sze += _temp_str.size ();
-
 			iter = cs_erase.erase (iter);
 			++cnt;
 		}
@@ -136,6 +362,80 @@ namespace shaga {
 		return _out_str;
 	}
 
+	void ChunkTool::to_bin (CHUNKDEQUE &lst_erase, std::string &out_append, const size_t max_size, const Chunk::Priority max_priority, const bool erase_skipped)
+	{
+		const size_t start_size = out_append.size ();
+		size_t cnt = 0;
+
+		/* Skipped chunks are compacted to the front, everything between write and iter is erased at once */
+		CHUNKDEQUE::iterator write = lst_erase.begin ();
+		CHUNKDEQUE::iterator iter = lst_erase.begin ();
+
+		bool full = false;
+		try {
+			for (; iter != lst_erase.end (); ++iter) {
+				if (iter->get_prio () > max_priority) {
+					if (false == erase_skipped) {
+						if (write != iter) {
+							*write = std::move (*iter);
+						}
+						++write;
+					}
+					continue;
+				}
+
+				if (_append_chunk (*iter, out_append, start_size, max_size) == false) {
+					full = true;
+					break;
+				}
+
+				++cnt;
+			}
+		}
+		catch (...) {
+			/* Range contains only chunks already written to the output and moved-from skipped chunks */
+			lst_erase.erase (write, iter);
+			throw;
+		}
+
+		lst_erase.erase (write, iter);
+
+		if (true == full && true == _enable_thr && 0 == cnt) {
+			cThrow ("Unable to add first chunk."sv);
+		}
+	}
+
+	std::string ChunkTool::to_bin (CHUNKDEQUE &lst_erase, const size_t max_size, const Chunk::Priority max_priority, const bool erase_skipped)
+	{
+		_out_str.resize (0);
+		to_bin (lst_erase, _out_str, max_size, max_priority, erase_skipped);
+		return _out_str;
+	}
+
+	void ChunkTool::to_bin (ChunkPrioSet &cs_erase, std::string &out_append, const size_t max_size, const Chunk::Priority max_priority)
+	{
+		_to_bin_buckets (cs_erase, out_append, max_size, max_priority);
+	}
+
+	std::string ChunkTool::to_bin (ChunkPrioSet &cs_erase, const size_t max_size, const Chunk::Priority max_priority)
+	{
+		_out_str.resize (0);
+		to_bin (cs_erase, _out_str, max_size, max_priority);
+		return _out_str;
+	}
+
+	void ChunkTool::to_bin (ChunkPrioQueue &cq_erase, std::string &out_append, const size_t max_size, const Chunk::Priority max_priority)
+	{
+		_to_bin_buckets (cq_erase, out_append, max_size, max_priority);
+	}
+
+	std::string ChunkTool::to_bin (ChunkPrioQueue &cq_erase, const size_t max_size, const Chunk::Priority max_priority)
+	{
+		_out_str.resize (0);
+		to_bin (cq_erase, _out_str, max_size, max_priority);
+		return _out_str;
+	}
+
 	void ChunkTool::change_source_hwid (CHUNKLIST &lst, const HWID new_source_hwid, const bool replace_only_zero)
 	{
 		/* TODO: add std::execution::par */
@@ -146,6 +446,15 @@ namespace shaga {
 		});
 	}
 
+	void ChunkTool::change_source_hwid (CHUNKDEQUE &lst, const HWID new_source_hwid, const bool replace_only_zero)
+	{
+		for (Chunk &chunk : lst) {
+			if (false == replace_only_zero || 0 == chunk._hwid_source) {
+				chunk._hwid_source = new_source_hwid;
+			}
+		}
+	}
+
 	void ChunkTool::trim (CHUNKSET &cset, const size_t treshold_size, const Chunk::Priority treshold_prio)
 	{
 		size_t sze = cset.size ();
@@ -177,6 +486,26 @@ namespace shaga {
 		cset.erase (++iter, cset.end ());
 	}
 
+	void ChunkTool::trim (ChunkPrioSet &cset, const size_t treshold_size, const Chunk::Priority treshold_prio)
+	{
+		_trim_buckets (cset, treshold_size, treshold_prio);
+	}
+
+	void ChunkTool::trim (ChunkPrioQueue &cq, const size_t treshold_size, const Chunk::Priority treshold_prio)
+	{
+		_trim_buckets (cq, treshold_size, treshold_prio);
+	}
+
+	void ChunkTool::purge (ChunkPrioSet &cset, std::function<bool (const Chunk &)> callback)
+	{
+		cset.purge (std::move (callback));
+	}
+
+	void ChunkTool::purge (ChunkPrioQueue &cq, std::function<bool (const Chunk &)> callback)
+	{
+		cq.purge (std::move (callback));
+	}
+
 	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 	//  Global functions  ///////////////////////////////////////////////////////////////////////////////////////////
 	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
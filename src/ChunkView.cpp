@@ -0,0 +1,413 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#include "shaga/common.h"
+
+namespace shaga {
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  Static functions  ///////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	static inline std::string_view _chunkview_read_block (const std::string_view bin, size_t &offset)
+	{
+		const size_t len = BIN::to_size (bin, offset);
+		if ((offset + len) > bin.size ()) {
+			cThrow ("Not enough data in buffer"sv);
+		}
+
+		const std::string_view out = bin.substr (offset, len);
+		offset += len;
+		return out;
+	}
+
+	/* Walk through meta entries without storing them. Callback returning false stops the walk. */
+	template <class F>
+	static inline void _chunkview_walk_meta (const std::string_view bin, size_t &offset, F callback)
+	{
+		uint16_t last_key = UINT16_MAX;
+
+		/* Meta continues until byte with highest bit set, which starts the next chunk */
+		while (offset < bin.size () && (static_cast<uint8_t> (bin[offset]) & 0x80) == 0) {
+			uint16_t key = BIN::to_uint8 (bin, offset) << 8;
+
+			if (ChunkMeta::key_repeat_mask == key) {
+				key = last_key;
+			}
+			else {
+				key |= BIN::to_uint8 (bin, offset);
+				last_key = key;
+			}
+
+			if (key < ChunkMeta::key_type_min || key > ChunkMeta::key_type_max) {
+				cThrow ("Unrecognized key value {}"sv, key);
+			}
+
+			const std::string_view value = _chunkview_read_block (bin, offset);
+			if (callback (key, value) == false) {
+				return;
+			}
+		}
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  Public class methods  ///////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	ChunkView::ChunkView (const std::string_view bin, size_t &offset, const Chunk::SPECIAL_TYPES *const special_types) :
+		_special_types (special_types)
+	{
+		if (offset >= bin.size () || (static_cast<uint8_t> (bin[offset]) & 0x80) == 0) {
+			cThrow ("Buffer is empty"sv);
+		}
+
+		const size_t start_offset {offset};
+
+		/* Read high 16-bit first (big endian) */
+		_val = BIN::be_to_uint16 (bin, offset) << 16;
+
+		_prio = uint8_to_priority ((_val & Chunk::key_prio_mask) >> Chunk::key_prio_shift);
+		_trust = uint8_to_trustlevel ((_val & Chunk::key_trust_mask) >> Chunk::key_trust_shift);
+		_ttl = ((_val & Chunk::key_ttl_mask) >> Chunk::key_ttl_shift);
+		_channel = ((_val & Chunk::key_channel_mask) != 0);
+
+		if ((_val & Chunk::key_tracert_mask) == Chunk::key_tracert_mask) {
+			_type = Chunk::key_type_tracert;
+		}
+		else if (_val & Chunk::key_special_type_mask) {
+			if (special_types == nullptr) {
+				cThrow ("Required special_types are not defined"sv);
+			}
+			_type = special_types->at ((_val >> 16) & Chunk::num_special_types);
+			if (HEDLEY_UNLIKELY (0 == _type)) {
+				cThrow ("Special type is not defined"sv);
+			}
+		}
+		else {
+			/* This is not tracert type, so read the rest of the 32-bit header */
+			const uint32_t lowval = BIN::be_to_uint16 (bin, offset);
+			_type = (_val | lowval) & Chunk::key_type_mask;
+		}
+
+		if (_type < Chunk::key_type_min || _type > Chunk::key_type_max) {
+			cThrow ("Unrecognized key value {}"sv, _type);
+		}
+
+		_hwid_source = bin_to_hwid (bin, offset);
+
+		_header_size = offset - start_offset;
+
+		if (Chunk::key_type_tracert == _type) {
+			_hops_count = BIN::to_uint8 (bin, offset);
+			if (_hops_count > Chunk::max_hop_counter) {
+				cThrow ("Too many tracert hops ({})"sv, static_cast<unsigned int> (_hops_count));
+			}
+			_hops_offset = offset - start_offset;
+
+			offset += static_cast<size_t> (_hops_count) * (sizeof (HWID) + 1);
+			if (offset > bin.size ()) {
+				cThrow ("Not enough data in buffer"sv);
+			}
+		}
+
+		if (_val & Chunk::key_has_dest_mask) {
+			_hwid_dest.mask = bin_to_hwid (bin, offset);
+			_hwid_dest.hwid = bin_to_hwid (bin, offset);
+		}
+
+		if (_val & Chunk::key_has_payload_mask) {
+			_payload = _chunkview_read_block (bin, offset);
+		}
+
+		if (_val & Chunk::key_has_cbor_mask) {
+			_cbor = _chunkview_read_block (bin, offset);
+		}
+
+		const size_t meta_offset {offset};
+		_chunkview_walk_meta (bin, offset, [](const uint16_t, const std::string_view) -> bool { return true; });
+		_meta = bin.substr (meta_offset, offset - meta_offset);
+
+		_bin = bin.substr (start_offset, offset - start_offset);
+	}
+
+	SHAGA_STRV std::string_view ChunkView::get_binary (void) const
+	{
+		return _bin;
+	}
+
+	size_t ChunkView::get_header_size (void) const
+	{
+		return _header_size;
+	}
+
+	bool ChunkView::is_primary_channel (void) const
+	{
+		return (true == _channel);
+	}
+
+	bool ChunkView::is_secondary_channel (void) const
+	{
+		return (false == _channel);
+	}
+
+	Chunk::Channel ChunkView::get_channel (void) const
+	{
+		return (true == _channel) ? Chunk::Channel::PRIMARY : Chunk::Channel::SECONDARY;
+	}
+
+	uint_fast8_t ChunkView::get_channel_bitmask (void) const
+	{
+		return (true == _channel) ? Chunk::channel_primary : Chunk::channel_secondary;
+	}
+
+	HWID ChunkView::get_source_hwid (void) const
+	{
+		return _hwid_source;
+	}
+
+	HWIDMASK ChunkView::get_destination_hwidmask (void) const
+	{
+		return _hwid_dest;
+	}
+
+	bool ChunkView::is_for_destination (const HWID hwid) const
+	{
+		return _hwid_dest.check (hwid);
+	}
+
+	bool ChunkView::is_for_destination (const HWID_LIST &lst) const
+	{
+		return std::any_of (lst.begin (), lst.end (), [this](const HWID hwid) {
+			return _hwid_dest.check (hwid);
+		});
+	}
+
+	std::string ChunkView::get_type (void) const
+	{
+		return Chunk::bin_to_key (_type);
+	}
+
+	uint32_t ChunkView::get_num_type (void) const
+	{
+		return _type;
+	}
+
+	Chunk::Priority ChunkView::get_prio (void) const
+	{
+		return _prio;
+	}
+
+	Chunk::TrustLevel ChunkView::get_trustlevel (void) const
+	{
+		return _trust;
+	}
+
+	bool ChunkView::check_maximal_trustlevel (const Chunk::TrustLevel trust) const
+	{
+		return (_trust <= trust);
+	}
+
+	uint8_t ChunkView::get_ttl (void) const
+	{
+		return _ttl;
+	}
+
+	bool ChunkView::is_zero_ttl (void) const
+	{
+		return (0 == _ttl);
+	}
+
+	size_t ChunkView::tracert_hops_count (void) const
+	{
+		return _hops_count;
+	}
+
+	Chunk::TRACERT_HOP ChunkView::tracert_hop (const size_t pos) const
+	{
+		if (pos >= _hops_count) {
+			cThrow ("Tracert hop {} is out of range"sv, pos);
+		}
+
+		size_t offset = _hops_offset + (pos * (sizeof (HWID) + 1));
+
+		Chunk::TRACERT_HOP hop;
+		hop.hwid = bin_to_hwid (_bin, offset);
+		hop.metric = BIN::to_uint8 (_bin, offset);
+		return hop;
+	}
+
+	bool ChunkView::has_payload (void) const
+	{
+		return (_payload.empty () == false);
+	}
+
+	SHAGA_STRV std::string_view ChunkView::get_payload (void) const
+	{
+		return _payload;
+	}
+
+	bool ChunkView::has_cbor (void) const
+	{
+		return (_cbor.empty () == false);
+	}
+
+	SHAGA_STRV std::string_view ChunkView::get_cbor (void) const
+	{
+		return _cbor;
+	}
+
+	CBOR::Reader ChunkView::get_cbor_reader (void) const
+	{
+		return CBOR::Reader (_cbor);
+	}
+
+	nlohmann::json ChunkView::get_json (void) const
+	{
+		return nlohmann::json::from_cbor (_cbor.begin (), _cbor.end ());
+	}
+
+	bool ChunkView::has_meta (void) const
+	{
+		return (_meta.empty () == false);
+	}
+
+	SHAGA_STRV std::string_view ChunkView::get_meta_binary (void) const
+	{
+		return _meta;
+	}
+
+	ChunkMeta ChunkView::get_meta (void) const
+	{
+		ChunkMeta meta;
+		size_t offset {0};
+		meta.from_bin (_meta, offset);
+		return meta;
+	}
+
+	SHAGA_STRV std::optional<std::string_view> ChunkView::get_meta_value (const uint16_t key) const
+	{
+		std::optional<std::string_view> out;
+		size_t offset {0};
+
+		_chunkview_walk_meta (_meta, offset, [&](const uint16_t k, const std::string_view value) -> bool {
+			if (k == key) {
+				out = value;
+				return false;
+			}
+			return true;
+		});
+
+		return out;
+	}
+
+	SHAGA_STRV std::optional<std::string_view> ChunkView::get_meta_value (const std::string_view key) const
+	{
+		return get_meta_value (ChunkMeta::key_to_bin (key));
+	}
+
+	Chunk ChunkView::to_chunk (const bool store_binary_representation) const
+	{
+		size_t offset {0};
+		return Chunk (_bin, offset, _special_types, store_binary_representation);
+	}
+
+	SHAGA_STRV std::string_view ChunkView::forward (std::string &bin, size_t &offset, const std::optional<HWID> hwid_source, const Chunk::SPECIAL_TYPES *const special_types)
+	{
+		const size_t start_offset {offset};
+		const ChunkView view (bin, offset, special_types);
+
+		if (0 == view._ttl) {
+			return std::string_view ();
+		}
+
+		/* TTL is stored in the first byte of big endian header */
+		const uint8_t ttl_mask = Chunk::key_ttl_mask >> 24;
+		const uint8_t ttl_shift = Chunk::key_ttl_shift - 24;
+		uint8_t &first = reinterpret_cast<uint8_t &> (bin[start_offset]);
+		first = (first & ~ttl_mask) | (((view._ttl - 1) << ttl_shift) & ttl_mask);
+
+		/* Source HWID is the last part of header */
+		if (hwid_source) {
+			_bin_from_hwid (*hwid_source, bin.data () + start_offset + view._header_size - sizeof (HWID));
+		}
+
+		return std::string_view (bin).substr (start_offset, offset - start_offset);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  ChunkBatch  /////////////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	void ChunkBatch::_decode (const Chunk::SPECIAL_TYPES *const special_types)
+	{
+		_views.clear ();
+
+		try {
+			size_t offset {0};
+			while (offset != _arena.size ()) {
+				_views.emplace_back (_arena, offset, special_types);
+			}
+		}
+		catch (...) {
+			clear ();
+			throw;
+		}
+	}
+
+	void ChunkBatch::decode (const std::string_view buf, const Chunk::SPECIAL_TYPES *const special_types)
+	{
+		_arena.assign (buf);
+		_decode (special_types);
+	}
+
+	void ChunkBatch::decode (std::string &&buf, const Chunk::SPECIAL_TYPES *const special_types)
+	{
+		_arena = std::move (buf);
+		_decode (special_types);
+	}
+
+	void ChunkBatch::clear (void)
+	{
+		_views.clear ();
+		_arena.resize (0);
+	}
+
+	void ChunkBatch::reset (void)
+	{
+		CHUNKVIEWS ().swap (_views);
+		std::string ().swap (_arena);
+	}
+
+	size_t ChunkBatch::size (void) const
+	{
+		return _views.size ();
+	}
+
+	bool ChunkBatch::empty (void) const
+	{
+		return _views.empty ();
+	}
+
+	CHUNKVIEWS::const_iterator ChunkBatch::begin (void) const
+	{
+		return _views.cbegin ();
+	}
+
+	CHUNKVIEWS::const_iterator ChunkBatch::end (void) const
+	{
+		return _views.cend ();
+	}
+
+	const ChunkView & ChunkBatch::operator[] (const size_t pos) const
+	{
+		return _views[pos];
+	}
+
+	SHAGA_STRV std::string_view ChunkBatch::get_binary (void) const
+	{
+		return _arena;
+	}
+}
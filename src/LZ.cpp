@@ -0,0 +1,357 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#include "shaga/common.h"
+
+namespace shaga {
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  Static functions  ///////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	/* Last match must start at least 12 bytes before end of block and last 5 bytes are always literals */
+	static const constexpr size_t _lz_mf_limit {12};
+	static const constexpr size_t _lz_last_literals {5};
+	static const constexpr size_t _lz_run_mask {15};
+
+	static inline uint32_t _lz_read32 (const char *const ptr)
+	{
+		uint32_t val;
+		::memcpy (&val, ptr, sizeof (val));
+		return val;
+	}
+
+	static inline uint32_t _lz_hash (const uint32_t val, const uint_fast32_t bits)
+	{
+		return (val * UINT32_C (2654435761)) >> (32 - bits);
+	}
+
+	static inline void _lz_write_length (size_t len, std::string &out)
+	{
+		while (len >= 255) {
+			out.push_back (static_cast<char> (255));
+			len -= 255;
+		}
+		out.push_back (static_cast<char> (len));
+	}
+
+	static inline size_t _lz_read_length (const std::string_view frame, size_t &offset)
+	{
+		size_t len {0};
+		uint8_t b;
+
+		do {
+			if (HEDLEY_UNLIKELY (offset >= frame.size ())) {
+				cThrow ("Not enough data in buffer"sv);
+			}
+			b = static_cast<uint8_t> (frame[offset++]);
+			len += b;
+		} while (255 == b);
+
+		return len;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  Compressor  /////////////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	LZ::Compressor::Compressor (const bool use_dictionary) :
+		_use_dictionary (use_dictionary)
+	{
+		reset ();
+	}
+
+	bool LZ::Compressor::_compress_block (const size_t start, std::string &out_append, const size_t limit)
+	{
+		const char *const base = _window.data ();
+		const size_t end = _window.size ();
+		const size_t mflimit = ((end - start) > _lz_mf_limit) ? (end - _lz_mf_limit) : start;
+		const size_t match_end_limit = end - _lz_last_literals;
+
+		size_t anchor {start};
+		size_t pos {start};
+
+		while (pos < mflimit) {
+			const uint32_t seq = _lz_read32 (base + pos);
+			const uint32_t h = _lz_hash (seq, _hash_bits);
+			const size_t ref = _table[h];
+			_table[h] = static_cast<uint32_t> (pos + 1);
+
+			if (0 == ref || (ref - 1) >= pos || (pos - (ref - 1)) > max_offset || _lz_read32 (base + ref - 1) != seq) {
+				/* Step faster over data that don't compress */
+				pos += 1 + ((pos - anchor) >> 6);
+				continue;
+			}
+
+			size_t mpos = ref - 1;
+
+			/* Extend match backwards over literals */
+			while (pos > anchor && mpos > 0 && base[pos - 1] == base[mpos - 1]) {
+				--pos;
+				--mpos;
+			}
+
+			size_t len {min_match};
+			while ((pos + len) < match_end_limit && base[pos + len] == base[mpos + len]) {
+				++len;
+			}
+
+			const size_t lit = pos - anchor;
+			const size_t ml = len - min_match;
+
+			out_append.push_back (static_cast<char> ((std::min (lit, _lz_run_mask) << 4) | std::min (ml, _lz_run_mask)));
+			if (lit >= _lz_run_mask) {
+				_lz_write_length (lit - _lz_run_mask, out_append);
+			}
+			out_append.append (base + anchor, lit);
+
+			BIN::from_uint16 (static_cast<uint16_t> (pos - mpos), out_append);
+			if (ml >= _lz_run_mask) {
+				_lz_write_length (ml - _lz_run_mask, out_append);
+			}
+
+			pos += len;
+			anchor = pos;
+
+			if (out_append.size () >= limit) {
+				return false;
+			}
+		}
+
+		/* Last literals */
+		const size_t lit = end - anchor;
+		out_append.push_back (static_cast<char> (std::min (lit, _lz_run_mask) << 4));
+		if (lit >= _lz_run_mask) {
+			_lz_write_length (lit - _lz_run_mask, out_append);
+		}
+		out_append.append (base + anchor, lit);
+
+		return (out_append.size () < limit);
+	}
+
+	void LZ::Compressor::_append_stored (const std::string_view plain, std::string &out_append)
+	{
+		out_append.push_back (static_cast<char> (frame_stored));
+		out_append.append (plain);
+	}
+
+	void LZ::Compressor::_trim_window (void)
+	{
+		if (false == _use_dictionary) {
+			/* State of skipping incompressible frames is kept */
+			_window.resize (0);
+			_table.fill (0);
+			_last_window_size = 0;
+			return;
+		}
+
+		if (_window.size () <= (dictionary_size * 2)) {
+			return;
+		}
+
+		const size_t shift = _window.size () - dictionary_size;
+		_window.erase (0, shift);
+		_last_window_size = (_last_window_size > shift) ? (_last_window_size - shift) : 0;
+
+		for (auto &entry : _table) {
+			entry = (entry > shift) ? static_cast<uint32_t> (entry - shift) : 0;
+		}
+	}
+
+	void LZ::Compressor::compress (const std::string_view plain, std::string &out_append)
+	{
+		_last_window_size = _window.size ();
+
+		if (plain.size () < min_compress_size || _skip_frames > 0) {
+			if (_skip_frames > 0) {
+				--_skip_frames;
+			}
+
+			_append_stored (plain, out_append);
+			_window.append (plain);
+			_trim_window ();
+			return;
+		}
+
+		const size_t start = _window.size ();
+		const size_t out_start = out_append.size ();
+		_window.append (plain);
+
+		out_append.push_back (static_cast<char> (frame_compressed));
+		BIN::from_size (plain.size (), out_append);
+
+		if (_compress_block (start, out_append, out_start + plain.size () + 1) == true) {
+			_skip_backoff = 0;
+		}
+		else {
+			/* Data don't compress, store them and skip next few frames */
+			out_append.resize (out_start);
+			_append_stored (plain, out_append);
+
+			_skip_backoff = std::min<uint_fast32_t> ((_skip_backoff * 2) + 1, 64);
+			_skip_frames = _skip_backoff;
+		}
+
+		_trim_window ();
+	}
+
+	std::string LZ::Compressor::compress (const std::string_view plain)
+	{
+		std::string out;
+		out.reserve (plain.size () + 1);
+		compress (plain, out);
+		return out;
+	}
+
+	void LZ::Compressor::rollback (void)
+	{
+		/* Stale table entries are harmless, every match is verified against window content */
+		if (_last_window_size < _window.size ()) {
+			_window.resize (_last_window_size);
+		}
+	}
+
+	void LZ::Compressor::reset (void)
+	{
+		_window.resize (0);
+		_table.fill (0);
+		_last_window_size = 0;
+		_skip_frames = 0;
+		_skip_backoff = 0;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  Decompressor  ///////////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	LZ::Decompressor::Decompressor (const bool use_dictionary) :
+		_use_dictionary (use_dictionary)
+	{ }
+
+	void LZ::Decompressor::_trim_window (void)
+	{
+		if (false == _use_dictionary) {
+			_window.resize (0);
+		}
+		else if (_window.size () > (dictionary_size * 2)) {
+			_window.erase (0, _window.size () - dictionary_size);
+		}
+	}
+
+	void LZ::Decompressor::decompress (const std::string_view frame, std::string &out_append)
+	{
+		if (frame.empty () == true) {
+			cThrow ("Frame is empty"sv);
+		}
+
+		size_t offset {1};
+		const uint8_t type = static_cast<uint8_t> (frame[0]);
+
+		if (frame_stored == type) {
+			const std::string_view plain = frame.substr (offset);
+			out_append.append (plain);
+			_window.append (plain);
+			_trim_window ();
+			return;
+		}
+		else if (frame_compressed != type) {
+			cThrow ("Unknown frame type {}"sv, type);
+		}
+
+		const size_t sze = BIN::to_size (frame, offset);
+
+		/* Every input byte can't produce more than 255 bytes of output */
+		if (sze > (frame.size () * 256)) {
+			cThrow ("Malformed data"sv);
+		}
+
+		const size_t start = _window.size ();
+		const size_t oend = start + sze;
+		size_t op {start};
+
+		try {
+			_window.resize (oend);
+			char *const base = _window.data ();
+
+			while (true) {
+				if (HEDLEY_UNLIKELY (offset >= frame.size ())) {
+					cThrow ("Not enough data in buffer"sv);
+				}
+
+				const uint8_t token = static_cast<uint8_t> (frame[offset++]);
+
+				size_t lit = token >> 4;
+				if (_lz_run_mask == lit) {
+					lit += _lz_read_length (frame, offset);
+				}
+
+				if (HEDLEY_UNLIKELY ((offset + lit) > frame.size () || (op + lit) > oend)) {
+					cThrow ("Malformed data"sv);
+				}
+
+				::memcpy (base + op, frame.data () + offset, lit);
+				op += lit;
+				offset += lit;
+
+				if (frame.size () == offset) {
+					/* Last sequence contains only literals */
+					break;
+				}
+
+				if (HEDLEY_UNLIKELY ((offset + 2) > frame.size ())) {
+					cThrow ("Not enough data in buffer"sv);
+				}
+
+				const size_t moff = BIN::_to_uint16 (frame.data () + offset);
+				offset += 2;
+
+				size_t ml = token & _lz_run_mask;
+				if (_lz_run_mask == ml) {
+					ml += _lz_read_length (frame, offset);
+				}
+				ml += min_match;
+
+				if (HEDLEY_UNLIKELY (0 == moff || moff > op || (op + ml) > oend)) {
+					cThrow ("Malformed data"sv);
+				}
+
+				if (moff >= ml) {
+					::memcpy (base + op, base + op - moff, ml);
+					op += ml;
+				}
+				else {
+					/* Overlapping match, copy byte by byte */
+					for (const size_t mend = op + ml; op < mend; ++op) {
+						base[op] = base[op - moff];
+					}
+				}
+			}
+
+			if (HEDLEY_UNLIKELY (op != oend)) {
+				cThrow ("Size mismatch"sv);
+			}
+		}
+		catch (...) {
+			_window.resize (start);
+			throw;
+		}
+
+		out_append.append (_window, start, sze);
+		_trim_window ();
+	}
+
+	std::string LZ::Decompressor::decompress (const std::string_view frame)
+	{
+		std::string out;
+		decompress (frame, out);
+		return out;
+	}
+
+	void LZ::Decompressor::reset (void)
+	{
+		_window.resize (0);
+	}
+}
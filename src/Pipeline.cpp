@@ -0,0 +1,219 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#include "shaga/common.h"
+
+#ifdef SHAGA_THREADING
+
+namespace shaga {
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  Static functions  ///////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	/* Idle stage spins for a while, then yields and finally sleeps */
+	static const constexpr uint_fast32_t _pipeline_spin_loops {64};
+	static const constexpr uint_fast32_t _pipeline_yield_loops {1024};
+	static const constexpr std::chrono::microseconds _pipeline_sleep {50};
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  PipelineStage  //////////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	PipelineStage::PipelineStage (const std::string_view name, const int core) :
+		_name (name),
+		_core (core)
+	{
+		#ifdef OS_LINUX
+		if (core < -1 || core >= CPU_SETSIZE) {
+			cThrow ("Stage '{}': Core {} is out of range"sv, _name, core);
+		}
+		#endif // OS_LINUX
+	}
+
+	PipelineStage::~PipelineStage ()
+	{
+		/* Derived classes must call stop () in destructor, _step () is not available here */
+		if (_thread.joinable () == true) {
+			_running.store (false, std::memory_order_release);
+			_thread.join ();
+		}
+	}
+
+	void PipelineStage::_thread_loop (std::promise<int> pinned)
+	{
+		/* Thread pins itself, so no batch is processed on a wrong core */
+		int ret {0};
+		#ifdef OS_LINUX
+		if (_core >= 0) {
+			cpu_set_t cpuset;
+			CPU_ZERO (&cpuset);
+			CPU_SET (_core, &cpuset);
+
+			ret = ::pthread_setaffinity_np (::pthread_self (), sizeof (cpuset), &cpuset);
+		}
+		#endif // OS_LINUX
+
+		pinned.set_value (ret);
+		if (ret != 0) {
+			return;
+		}
+
+		uint_fast32_t idle {0};
+
+		while (_running.load (std::memory_order_acquire) == true) {
+			bool done;
+
+			try {
+				done = _step ();
+			}
+			catch (...) {
+				_count (_errors);
+				done = true;
+			}
+
+			if (true == done) {
+				idle = 0;
+			}
+			else if (idle < _pipeline_spin_loops) {
+				++idle;
+			}
+			else if (idle < _pipeline_yield_loops) {
+				++idle;
+				std::this_thread::yield ();
+			}
+			else {
+				std::this_thread::sleep_for (_pipeline_sleep);
+			}
+		}
+	}
+
+	void PipelineStage::start (void)
+	{
+		if (_thread.joinable () == true) {
+			cThrow ("Stage '{}' is already running"sv, _name);
+		}
+
+		std::promise<int> pinned;
+		std::future<int> result = pinned.get_future ();
+
+		_running.store (true, std::memory_order_release);
+		_thread = std::thread (&PipelineStage::_thread_loop, this, std::move (pinned));
+
+		const int ret = result.get ();
+		if (ret != 0) {
+			stop ();
+			cThrow ("Stage '{}': Unable to pin thread to core {}: {}"sv, _name, _core, strerror (ret));
+		}
+	}
+
+	void PipelineStage::stop (void)
+	{
+		_running.store (false, std::memory_order_release);
+
+		if (_thread.joinable () == true) {
+			_thread.join ();
+		}
+	}
+
+	bool PipelineStage::is_running (void) const
+	{
+		return _running.load (std::memory_order_relaxed);
+	}
+
+	const std::string & PipelineStage::get_name (void) const
+	{
+		return _name;
+	}
+
+	PIPELINE_COUNTERS PipelineStage::get_counters (void) const
+	{
+		PIPELINE_COUNTERS out;
+
+		out.batches_in = _batches_in.load (std::memory_order_relaxed);
+		out.items_in = _items_in.load (std::memory_order_relaxed);
+		out.batches_out = _batches_out.load (std::memory_order_relaxed);
+		out.items_out = _items_out.load (std::memory_order_relaxed);
+		out.errors = _errors.load (std::memory_order_relaxed);
+		out.stalls = _stalls.load (std::memory_order_relaxed);
+
+		return out;
+	}
+
+	void PipelineStage::reset_counters (void)
+	{
+		_batches_in.store (0, std::memory_order_relaxed);
+		_items_in.store (0, std::memory_order_relaxed);
+		_batches_out.store (0, std::memory_order_relaxed);
+		_items_out.store (0, std::memory_order_relaxed);
+		_errors.store (0, std::memory_order_relaxed);
+		_stalls.store (0, std::memory_order_relaxed);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	//  Pipeline  ///////////////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+	Pipeline::~Pipeline ()
+	{
+		stop ();
+	}
+
+	void Pipeline::start (void)
+	{
+		_check_not_running ();
+
+		try {
+			for (auto &stage : _stages) {
+				stage->start ();
+			}
+		}
+		catch (...) {
+			for (auto &stage : _stages) {
+				stage->stop ();
+			}
+			throw;
+		}
+
+		_running = true;
+	}
+
+	void Pipeline::stop (void)
+	{
+		/* Data left in rings are kept, pipeline can be started again */
+		for (auto &stage : _stages) {
+			stage->stop ();
+		}
+
+		_running = false;
+	}
+
+	bool Pipeline::is_running (void) const
+	{
+		return _running;
+	}
+
+	std::vector<std::pair<std::string, PIPELINE_COUNTERS>> Pipeline::get_counters (void) const
+	{
+		std::vector<std::pair<std::string, PIPELINE_COUNTERS>> out;
+		out.reserve (_stages.size ());
+
+		for (const auto &stage : _stages) {
+			out.emplace_back (stage->get_name (), stage->get_counters ());
+		}
+
+		return out;
+	}
+
+	void Pipeline::reset_counters (void)
+	{
+		for (auto &stage : _stages) {
+			stage->reset_counters ();
+		}
+	}
+}
+
+#endif // SHAGA_THREADING
@@ -0,0 +1,147 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#include <gtest/gtest.h>
+
+using namespace shaga;
+
+TEST (CBOR, writer)
+{
+	CBOR::Writer w;
+	w.map (7);
+	w.entry ("happy", true);
+	w.entry ("pi", 3.141);
+	w.entry ("half", 0.5);
+	w.entry ("small", -10);
+	w.entry ("big", UINT64_MAX);
+	w.entry ("min", INT64_MIN);
+	w.value ("list").array ().value (1).value ("two"sv).null ().end ();
+
+	const nlohmann::json expected = {
+		{"happy", true},
+		{"pi", 3.141},
+		{"half", 0.5},
+		{"small", -10},
+		{"big", UINT64_MAX},
+		{"min", INT64_MIN},
+		{"list", {1, "two", nullptr}},
+	};
+
+	EXPECT_TRUE (nlohmann::json::from_cbor (w.data ()) == expected);
+
+	Chunk chunk (1, "ABCD");
+	chunk.set_cbor (w.release ());
+	EXPECT_TRUE (w.empty ());
+	EXPECT_TRUE (chunk.get_json () == expected);
+}
+
+TEST (CBOR, reader)
+{
+	const nlohmann::json data = {
+		{"a", {{"nested", {1, 2, {{"x", "y"}}}}}},
+		{"b", -1000000000000LL},
+		{"c", 1.5},
+		{"d", "text"},
+		{"e", false},
+		{"f", nullptr},
+		{"g", nlohmann::json::binary ({1, 2, 3})},
+	};
+
+	const Chunk chunk (1, "ABCD", data);
+
+	/* Typed access to fields, nested content is skipped */
+	auto r = chunk.get_cbor_reader ();
+	ASSERT_TRUE (r.find_key ("b"));
+	EXPECT_TRUE (r.read_int () == -1000000000000LL);
+
+	r = chunk.get_cbor_reader ();
+	ASSERT_TRUE (r.find_key ("d"));
+	EXPECT_TRUE (r.peek () == CBOR::Type::TEXT);
+	const std::string_view text = r.read_text ();
+	EXPECT_TRUE (text == "text"sv);
+	/* Strings point into the chunk */
+	EXPECT_TRUE (text.data () >= reinterpret_cast<const char *> (chunk.get_cbor ().data ()));
+	EXPECT_TRUE (text.data () < reinterpret_cast<const char *> (chunk.get_cbor ().data () + chunk.get_cbor ().size ()));
+
+	r = chunk.get_cbor_reader ();
+	ASSERT_TRUE (r.find_key ("c"));
+	EXPECT_TRUE (r.read_double () == 1.5);
+
+	r = chunk.get_cbor_reader ();
+	ASSERT_TRUE (r.find_key ("e"));
+	EXPECT_FALSE (r.read_bool ());
+
+	r = chunk.get_cbor_reader ();
+	ASSERT_TRUE (r.find_key ("f"));
+	EXPECT_TRUE (r.peek () == CBOR::Type::NUL);
+	r.read_null ();
+
+	r = chunk.get_cbor_reader ();
+	ASSERT_TRUE (r.find_key ("g"));
+	EXPECT_TRUE (r.read_bytes () == "\x01\x02\x03"sv);
+
+	r = chunk.get_cbor_reader ();
+	EXPECT_FALSE (r.find_key ("missing"));
+	EXPECT_TRUE (r.at_end ());
+
+	/* Walk nested content */
+	r = chunk.get_cbor_reader ();
+	ASSERT_TRUE (r.find_key ("a"));
+	ASSERT_TRUE (r.find_key ("nested"));
+	ASSERT_TRUE (r.read_array () == 3);
+	EXPECT_TRUE (r.read_uint () == 1);
+	EXPECT_TRUE (r.read_int () == 2);
+	ASSERT_TRUE (r.find_key ("x"));
+	EXPECT_TRUE (r.read_text () == "y"sv);
+
+	/* Type mismatch */
+	r = chunk.get_cbor_reader ();
+	ASSERT_TRUE (r.find_key ("d"));
+	EXPECT_THROW (r.read_uint (), CommonException);
+	EXPECT_TRUE (r.read_text () == "text"sv);
+
+	/* Indefinite containers and half precision float */
+	CBOR::Writer w;
+	w.map ().entry ("k", 1).value ("l").array ().value (true).end ().end ();
+	w.value (INT64_MAX);
+	const uint8_t half[] = {0xF9, 0x3E, 0x00};
+	std::vector<uint8_t> buf = w.release ();
+	buf.insert (buf.end (), half, half + sizeof (half));
+
+	CBOR::Reader ri (buf);
+	EXPECT_TRUE (ri.read_map () == CBOR::indefinite);
+	EXPECT_TRUE (ri.read_text () == "k"sv);
+	EXPECT_TRUE (ri.read_uint () == 1);
+	EXPECT_TRUE (ri.read_text () == "l"sv);
+	EXPECT_TRUE (ri.read_array () == CBOR::indefinite);
+	EXPECT_TRUE (ri.read_bool ());
+	EXPECT_TRUE (ri.read_break ());
+	EXPECT_TRUE (ri.read_break ());
+	EXPECT_TRUE (ri.read_int () == INT64_MAX);
+	EXPECT_TRUE (ri.peek () == CBOR::Type::FLOAT);
+	EXPECT_TRUE (ri.read_double () == 1.5);
+	EXPECT_TRUE (ri.peek () == CBOR::Type::END);
+
+	ri = CBOR::Reader (buf);
+	ri.skip ();
+	EXPECT_TRUE (ri.read_int () == INT64_MAX);
+}
+
+TEST (CBOR, malformed)
+{
+	const std::vector<uint8_t> cbor = nlohmann::json::to_cbor ({{"key", "value"}, {"list", {1, 2, 3}}});
+
+	for (size_t len = 0; len < cbor.size (); ++len) {
+		CBOR::Reader r (std::string_view (reinterpret_cast<const char *> (cbor.data ()), len));
+		EXPECT_ANY_THROW (r.skip ());
+	}
+
+	/* Nesting is limited */
+	const std::string deep (CBOR::max_depth + 2, '\x81');
+	CBOR::Reader r (deep);
+	EXPECT_THROW (r.skip (), CommonException);
+}
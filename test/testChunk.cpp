@@ -227,6 +227,26 @@ TEST (Chunk, tracert)
 
 	EXPECT_TRUE (c2.tracert_hops_count () == 0);
 	EXPECT_TRUE (d2.tracert_hops_count () == 0);
+	EXPECT_TRUE (d2.tracert_hops_get ().empty ());
+
+	EXPECT_TRUE (v2[2].hwid == 2);
+	EXPECT_TRUE (v2[2].metric == 2);
+
+	/* Number of hops is limited */
+	for (size_t i = 3; i < Chunk::max_hop_counter; ++i) {
+		EXPECT_TRUE (c1.tracert_hops_add (i, i));
+	}
+	EXPECT_FALSE (c1.tracert_hops_add (0, 0));
+	EXPECT_TRUE (c1.tracert_hops_count () == Chunk::max_hop_counter);
+
+	/* Decoding of too many hops fails. Counter follows 16-bit header and source HWID. */
+	std::string bin = c1.to_bin ();
+	bin[2 + sizeof (HWID)] = Chunk::max_hop_counter + 1;
+	bin.append (sizeof (HWID) + 1, '\0');
+	offset = 0;
+	EXPECT_THROW (Chunk (bin, offset), CommonException);
+	offset = 0;
+	EXPECT_THROW (ChunkView (bin, offset), CommonException);
 }
 
 TEST (Chunk, stored_binary)
@@ -0,0 +1,69 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#include <gtest/gtest.h>
+
+using namespace shaga;
+
+TEST (ChunkDedup, duplicates)
+{
+	ChunkDedup dedup (100, 1000);
+
+	Chunk a (1, "ABCD", "payload"sv);
+	Chunk b (1, "ABCD", "payload2"sv);
+	Chunk trac (1, "TRAC", "payload"sv);
+
+	EXPECT_FALSE (dedup.is_duplicate (a, 10));
+	EXPECT_FALSE (dedup.is_duplicate (b, 10));
+	EXPECT_FALSE (dedup.is_duplicate (trac, 10));
+	EXPECT_TRUE (dedup.is_duplicate (a, 20));
+	EXPECT_TRUE (dedup.size () == 3);
+
+	/* TTL and tracert hops change on the way and are ignored */
+	a.hop_ttl ();
+	trac.hop_ttl ();
+	trac.tracert_hops_add (5, 1);
+	EXPECT_TRUE (dedup.is_duplicate (a, 30));
+	EXPECT_TRUE (dedup.is_duplicate (trac, 30));
+
+	/* Different source is different chunk */
+	Chunk c (2, "ABCD", "payload"sv);
+	EXPECT_FALSE (dedup.is_duplicate (c, 30));
+
+	/* Raw buffer, checked before decoding */
+	std::string bin = b.to_bin ();
+	bin.append (c.to_bin ());
+	size_t offset {0};
+	EXPECT_TRUE (dedup.is_duplicate (bin, offset, 40));
+	EXPECT_TRUE (dedup.is_duplicate (bin, offset, 40));
+	EXPECT_TRUE (offset == bin.size ());
+
+	/* Remembered for at least one period, forgotten after two */
+	EXPECT_TRUE (dedup.is_duplicate (b, 1500));
+	EXPECT_TRUE (dedup.is_duplicate (b, 2400));
+	EXPECT_FALSE (dedup.is_duplicate (Chunk (3, "ABCD"), 2400));
+	EXPECT_FALSE (dedup.is_duplicate (a, 5000));
+	EXPECT_TRUE (dedup.size () == 1);
+
+	dedup.clear ();
+	EXPECT_TRUE (dedup.size () == 0);
+	EXPECT_FALSE (dedup.is_duplicate (a, 5000));
+}
+
+TEST (ChunkDedup, capacity)
+{
+	ChunkDedup dedup (1000, 1'000'000);
+
+	for (HWID i = 1; i <= 5000; ++i) {
+		EXPECT_FALSE (dedup.is_duplicate (Chunk (i, "ABCD"), 1));
+	}
+
+	/* Memory is fixed, so only the last chunks are remembered */
+	EXPECT_TRUE (dedup.size () <= 2000);
+	EXPECT_TRUE (dedup.is_duplicate (Chunk (5000, "ABCD"), 1));
+	EXPECT_FALSE (dedup.is_duplicate (Chunk (1, "ABCD"), 1));
+}
@@ -0,0 +1,83 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#include <gtest/gtest.h>
+
+using namespace shaga;
+
+typedef std::map<uint32_t, size_t> DISPATCH_COUNTERS;
+
+static void _dispatch_count (DISPATCH_COUNTERS &ctx, const Chunk &chunk)
+{
+	++ctx[chunk.get_num_type ()];
+}
+
+static void _dispatch_unknown (DISPATCH_COUNTERS &ctx, const Chunk &)
+{
+	++ctx[0];
+}
+
+TEST (ChunkDispatch, dispatch)
+{
+	static constexpr ChunkDispatch<DISPATCH_COUNTERS, 5> dispatch ({{
+		{ChKEY ("AAAA"), &_dispatch_count},
+		{ChKEY ("ABCD"), &_dispatch_count},
+		{ChKEY ("TRAC"), &_dispatch_count},
+		{ChKEY ("ZZZZ"), &_dispatch_count},
+		{ChKEY ("PING"), [](DISPATCH_COUNTERS &counters, const Chunk &) -> void { counters[UINT32_MAX] += 10; }},
+	}});
+
+	static_assert (dispatch.contains (ChKEY ("ABCD")), "Type must be registered");
+	static_assert (dispatch.contains (ChKEY ("PING")), "Type must be registered");
+	static_assert (dispatch.contains (ChKEY ("BBBB")) == false, "Type must not be registered");
+	static_assert (dispatch.find (ChKEY ("BBBB")) == nullptr, "Fallback is not defined");
+
+	CHUNKLIST lst;
+	lst.emplace_back (1, "AAAA");
+	lst.emplace_back (1, "ABCD");
+	lst.emplace_back (1, "ABCD");
+	lst.emplace_back (1, "BBBB");
+	lst.emplace_back (1, "PING");
+	lst.emplace_back (1, "ZZZZ");
+
+	DISPATCH_COUNTERS ctx;
+	EXPECT_TRUE (dispatch.dispatch_all (ctx, lst) == 5);
+	EXPECT_TRUE (ctx == DISPATCH_COUNTERS ({{ChKEY ("AAAA"), 1}, {ChKEY ("ABCD"), 2}, {ChKEY ("ZZZZ"), 1}, {UINT32_MAX, 10}}));
+
+	/* Fallback and views */
+	static constexpr ChunkDispatch<DISPATCH_COUNTERS, 1, ChunkView> view_dispatch ({{
+		{ChKEY ("ABCD"), [](DISPATCH_COUNTERS &counters, const ChunkView &view) -> void { ++counters[view.get_num_type ()]; }},
+	}}, [](DISPATCH_COUNTERS &counters, const ChunkView &) -> void { ++counters[0]; });
+
+	ChunkTool tool (nullptr);
+	ChunkBatch batch;
+	tool.from_bin (tool.to_bin (lst), batch);
+	ASSERT_TRUE (batch.size () == 6);
+
+	ctx.clear ();
+	EXPECT_TRUE (view_dispatch.dispatch_all (ctx, batch) == 6);
+	EXPECT_TRUE (ctx == DISPATCH_COUNTERS ({{0, 4}, {ChKEY ("ABCD"), 2}}));
+
+	/* Invalid tables are rejected, at compile time when used as constexpr */
+	typedef ChunkDispatch<DISPATCH_COUNTERS, 2> DISPATCH2;
+	EXPECT_THROW (DISPATCH2 ({{{ChKEY ("ABCD"), &_dispatch_count}, {ChKEY ("ABCD"), &_dispatch_unknown}}}), CommonException);
+	EXPECT_THROW (DISPATCH2 ({{{ChKEY ("ABCD"), &_dispatch_count}, {0, &_dispatch_count}}}), CommonException);
+	EXPECT_THROW (DISPATCH2 ({{{ChKEY ("ABCD"), &_dispatch_count}, {ChKEY ("ABCE"), nullptr}}}), CommonException);
+
+	/* Larger table */
+	static constexpr auto many = [] () constexpr {
+		std::array<ChunkDispatch<DISPATCH_COUNTERS, 64>::Entry, 64> out {};
+		for (uint32_t i = 0; i < 64; ++i) {
+			out[i] = {ChKEY ("AAAA") + (i * 26), &_dispatch_count};
+		}
+		return out;
+	}();
+	static constexpr ChunkDispatch<DISPATCH_COUNTERS, 64> large (many);
+	for (uint32_t i = 0; i < 64 * 26; ++i) {
+		EXPECT_TRUE (large.contains (ChKEY ("AAAA") + i) == (i % 26 == 0));
+	}
+}
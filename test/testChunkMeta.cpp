@@ -467,3 +467,116 @@ TEST (ChunkMeta, bin)
 		EXPECT_TRUE (meta1.count (key) == 2);
 	}
 }
+
+TEST (ChunkMeta, sorted_storage)
+{
+	ChunkMeta meta;
+
+	meta.add_value ("ZZZ", "z1"sv);
+	meta.add_value ("AAA", "a1"sv);
+	meta.add_value ("MMM", "m1"sv);
+	meta.add_value ("AAA", "a2"sv);
+	meta.add_value ("ZZZ", "z2"sv);
+	meta.add_value ("AAA", "a3"sv);
+
+	/* Entries are sorted by key, repeated keys in order of insertion */
+	uint_fast16_t last_key {0};
+	for (const auto &[key, value] : meta) {
+		EXPECT_TRUE (key >= last_key);
+		last_key = key;
+	}
+
+	const auto values = meta.get_values<std::vector<std::string>> ("AAA");
+	ASSERT_EQ (values.size (), 3u);
+	EXPECT_EQ (values[0], "a1");
+	EXPECT_EQ (values[1], "a2");
+	EXPECT_EQ (values[2], "a3");
+	EXPECT_EQ (meta.get_value ("ZZZ"), "z1"sv);
+
+	/* Binary representation is deterministic and survives round trip */
+	const std::string bin = meta.to_bin ();
+	ChunkMeta restored;
+	size_t offset {0};
+	restored.from_bin (bin, offset);
+	EXPECT_EQ (restored.to_bin (), bin);
+	EXPECT_EQ (restored.get_values<std::vector<std::string>> ("AAA"), values);
+
+	/* Repeated keys are grouped, so every key is written only once */
+	EXPECT_EQ (bin.size (), (3 * 2) + (3 * 1) + (6 * 3));
+
+	/* Binary with keys out of order is sorted while decoding */
+	std::string crafted;
+	BIN::be_from_uint16 (ChMetaKEY ("ZZZ"), crafted);
+	BIN::from_size (1, crafted);
+	crafted.append ("z");
+	BIN::be_from_uint16 (ChMetaKEY ("AAA"), crafted);
+	BIN::from_size (1, crafted);
+	crafted.append ("a");
+
+	ChunkMeta unsorted;
+	offset = 0;
+	unsorted.from_bin (crafted, offset);
+	ASSERT_EQ (unsorted.size (), 2u);
+	EXPECT_EQ (unsorted.cbegin ()->first, ChMetaKEY ("AAA"));
+	EXPECT_EQ (unsorted.get_value ("ZZZ"), "z"sv);
+
+	EXPECT_EQ (meta.erase ("MMM"), 1u);
+	EXPECT_EQ (meta.find ("MMM"), meta.cend ());
+	EXPECT_EQ (meta.count ("AAA"), 3u);
+	EXPECT_EQ (meta.count ("ZZZ"), 2u);
+}
+
+TEST (ChunkMeta, native_numbers)
+{
+	ChunkMeta meta;
+
+	/* Values containing zero bytes */
+	meta.add_int32 ("AAA", 256);
+	meta.add_int16 ("BBB", -256);
+	meta.add_uint24 ("CCC", 0x10000);
+	meta.add_int64 ("DDD", INT64_MIN);
+	meta.add_bool ("EEE", false);
+	meta.add_uint24 ("FFF", 0x123456);
+
+	EXPECT_EQ (meta.get_int32 ("AAA", 0), 256);
+	EXPECT_EQ (meta.get_int16 ("BBB", 0), -256);
+	EXPECT_EQ (meta.get_uint24 ("CCC", 0), 0x10000u);
+	EXPECT_EQ (meta.get_uint24 ("FFF", 0), 0x123456u);
+	EXPECT_EQ (meta.get_int64 ("DDD", 0), INT64_MIN);
+	EXPECT_EQ (meta.get_bool ("EEE", true), false);
+	EXPECT_EQ (meta.get_bool ("XXX", true), true);
+
+	/* Typed get_value */
+	EXPECT_EQ (meta.get_value<int32_t> ("AAA"), 256);
+	EXPECT_EQ (meta.get_value<int16_t> ("BBB"), -256);
+	EXPECT_EQ (meta.get_value<uint32_t> ("XXX"), 0u);
+	EXPECT_EQ (meta.get_value_optional<int64_t> ("DDD"), INT64_MIN);
+	EXPECT_FALSE (meta.get_value_optional<uint64_t> ("AAA").has_value ());
+	EXPECT_EQ (meta.get_value_optional<bool> ("EEE"), false);
+	EXPECT_EQ (meta.get_value ("AAA").size (), 4u);
+
+	/* Overwrite in place */
+	meta.set_value ("SEQ", static_cast<uint32_t> (1));
+	EXPECT_EQ (meta.count ("SEQ"), 1u);
+	for (uint32_t i = 2; i < 100; ++i) {
+		meta.set_value ("SEQ", i);
+	}
+	EXPECT_EQ (meta.count ("SEQ"), 1u);
+	EXPECT_EQ (meta.get_uint32 ("SEQ", 0), 99u);
+	EXPECT_TRUE (meta.get_value ("SEQ") == BIN::from_uint32 (99));
+
+	meta.set_value ("AAA", static_cast<int16_t> (-2));
+	EXPECT_EQ (meta.get_value ("AAA").size (), 2u);
+	EXPECT_EQ (meta.get_int16 ("AAA", 0), -2);
+	EXPECT_TRUE (meta.get_value ("AAA") == BIN::from_int16 (-2));
+
+	meta.set_value ("EEE", true);
+	EXPECT_EQ (meta.get_bool ("EEE", false), true);
+
+	const std::string bin = meta.to_bin ();
+	ChunkMeta restored;
+	size_t offset {0};
+	restored.from_bin (bin, offset);
+	EXPECT_EQ (restored.get_uint32 ("SEQ", 0), 99u);
+	EXPECT_EQ (restored.get_value<int64_t> ("DDD"), INT64_MIN);
+}
@@ -0,0 +1,201 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#include <gtest/gtest.h>
+
+using namespace shaga;
+
+static CHUNKLIST _pack_generate (const size_t cnt)
+{
+	CHUNKLIST lst;
+	for (size_t i = 0; i < cnt; ++i) {
+		Chunk &chunk = lst.emplace_back ((i % 5 == 4) ? 7 : 1, (i % 6 == 5) ? "TRAC" : "ABCD");
+		chunk.set_prio (static_cast<Chunk::Priority> (i % 4));
+		chunk.set_trustlevel (static_cast<Chunk::TrustLevel> ((i / 4) % 4));
+		chunk.set_channel (i % 2 == 0);
+		chunk.set_ttl (static_cast<uint8_t> (i % 8));
+
+		switch (i % 4) {
+			case 0:
+				chunk.set_destination_hwid (0x100);
+				break;
+			case 1:
+				chunk.set_destination_hwid (HWIDMASK (0x200 + i, 0xFF00));
+				break;
+			case 2:
+				chunk.set_destination_hwid (0x100);
+				break;
+			default:
+				break;
+		}
+
+		if (chunk.get_num_type () == Chunk::key_type_tracert) {
+			chunk.tracert_hops_add (3, 1);
+			chunk.tracert_hops_add (4, 2);
+		}
+		if (i % 3 == 0) {
+			chunk.set_payload (fmt::format ("payload {} payload {} payload"sv, i, i));
+		}
+		if (i % 7 == 0) {
+			chunk.set_json ({{"id", i}});
+		}
+		chunk.meta.add_uint32 ("CNT", static_cast<uint32_t> (i));
+		if (i % 2 == 0) {
+			chunk.meta.add_value ("NAM", "name"sv);
+		}
+	}
+	return lst;
+}
+
+TEST (ChunkPack, roundtrip)
+{
+	Chunk::SPECIAL_TYPES special_types {};
+	special_types[0] = ChKEY ("ABCD");
+
+	for (const bool compress : {false, true}) {
+		for (const Chunk::SPECIAL_TYPES *st : {static_cast<const Chunk::SPECIAL_TYPES *> (nullptr), static_cast<const Chunk::SPECIAL_TYPES *> (&special_types)}) {
+			for (const size_t cnt : {0, 1, 2, 100}) {
+				ChunkPack pack (compress, st);
+				ChunkTool tool (false, st);
+
+				CHUNKLIST lst = _pack_generate (cnt);
+				CHUNKLIST copy = lst;
+
+				std::string plain;
+				for (const auto &chunk : lst) {
+					chunk.to_bin (plain, st);
+				}
+
+				const std::string bin = pack.to_bin (lst);
+				ASSERT_TRUE (lst.empty ());
+				if (cnt >= 100) {
+					ASSERT_TRUE (bin.size () < plain.size ());
+				}
+
+				/* Trailing data belong to the next batch */
+				const std::string buf = bin + "X"s;
+
+				CHUNKLIST out;
+				size_t offset {0};
+				pack.from_bin (buf, offset, out);
+				ASSERT_TRUE (offset == bin.size ());
+				ASSERT_TRUE (out.size () == cnt);
+
+				std::string out_plain;
+				for (const auto &chunk : out) {
+					chunk.to_bin (out_plain, st);
+				}
+				ASSERT_TRUE (out_plain == plain);
+
+				/* Chunks may be located through index */
+				ChunkPack::Batch batch;
+				offset = 0;
+				pack.decode (buf, offset, batch);
+				ASSERT_TRUE (batch.size () == cnt);
+				if (cnt > 0) {
+					const Chunk last = batch.get (cnt - 1);
+					ASSERT_TRUE (last.to_bin (st) == copy.back ().to_bin (st));
+					ASSERT_TRUE (last.meta.get_uint32 ("CNT", 0) == cnt - 1);
+				}
+				ASSERT_ANY_THROW (batch.get (cnt));
+			}
+		}
+	}
+}
+
+TEST (ChunkPack, compression)
+{
+	ChunkPack pack (true);
+
+	CHUNKLIST lst;
+	for (size_t i = 0; i < 50; ++i) {
+		Chunk &chunk = lst.emplace_back (1, "DATA");
+		chunk.set_destination_hwid (2);
+		chunk.set_payload ("status: online, temperature: 21.5, humidity: 40"sv);
+	}
+
+	CHUNKLIST copy = lst;
+	const size_t plain_size = ChunkTool ().to_bin (copy).size ();
+	const std::string bin = pack.to_bin (lst);
+	ASSERT_TRUE ((bin.size () * 4) < plain_size);
+
+	CHUNKDEQUE out;
+	size_t offset {0};
+	pack.from_bin (bin, offset, out);
+	ASSERT_TRUE (out.size () == 50);
+	ASSERT_TRUE (out.back ().get_payload () == "status: online, temperature: 21.5, humidity: 40");
+	ASSERT_TRUE (out.back ().is_for_destination (2));
+}
+
+TEST (ChunkPack, malformed)
+{
+	ChunkPack pack (false);
+	CHUNKLIST lst = _pack_generate (20);
+	const std::string bin = pack.to_bin (lst);
+
+	CHUNKLIST out;
+	for (size_t len = 0; len < bin.size (); ++len) {
+		size_t offset {0};
+		ASSERT_ANY_THROW (pack.from_bin (std::string_view (bin).substr (0, len), offset, out));
+		ASSERT_TRUE (offset == 0);
+		ASSERT_TRUE (out.empty ());
+	}
+
+	std::string wrong_version (bin);
+	wrong_version[0] = static_cast<char> (0x20);
+	size_t offset {0};
+	ASSERT_ANY_THROW (pack.from_bin (wrong_version, offset, out));
+}
+
+TEST (ChunkPack, limits)
+{
+	ChunkPack pack (false);
+
+	const CHUNKLIST lst = _pack_generate (100);
+	const size_t mandatory = std::count_if (lst.cbegin (), lst.cend (), [](const Chunk &chunk) -> bool { return chunk.get_prio () <= Chunk::Priority::pMANDATORY; });
+
+	/* Batches never exceed max_size and skipped chunks stay in original order */
+	CHUNKDEQUE deq (lst.cbegin (), lst.cend ());
+	CHUNKDEQUE out;
+	while (deq.size () > (lst.size () - mandatory)) {
+		const std::string bin = pack.to_bin (deq, 300, Chunk::Priority::pMANDATORY);
+		ASSERT_TRUE (bin.size () <= 300);
+
+		size_t offset {0};
+		pack.from_bin (bin, offset, out);
+		ASSERT_TRUE (offset == bin.size ());
+	}
+	ASSERT_TRUE (out.size () == mandatory);
+	ASSERT_TRUE (std::all_of (deq.cbegin (), deq.cend (), [](const Chunk &chunk) -> bool { return chunk.get_prio () > Chunk::Priority::pMANDATORY; }));
+	ASSERT_TRUE (std::is_sorted (deq.cbegin (), deq.cend (), [](const Chunk &a, const Chunk &b) -> bool { return a.meta.get_uint32 ("CNT", 0) < b.meta.get_uint32 ("CNT", 0); }));
+
+	CHUNKLIST skipped (lst);
+	pack.to_bin (skipped, 0, Chunk::Priority::pMANDATORY, true);
+	ASSERT_TRUE (skipped.empty ());
+
+	/* List is untouched if not even the first chunk fits */
+	CHUNKLIST small (lst);
+	ASSERT_ANY_THROW (pack.to_bin (small, 10));
+	ASSERT_TRUE (small.size () == lst.size ());
+}
+
+TEST (ChunkPack, most_used)
+{
+	ChunkPack pack (false);
+
+	/* Majority vote would pick the last source */
+	CHUNKLIST lst;
+	for (const HWID source : {1, 1, 2, 3, 4}) {
+		lst.emplace_back (source, "ABCD");
+	}
+
+	const std::string bin = pack.to_bin (lst);
+	size_t offset {0};
+	BIN::to_uint8 (bin, offset);
+	ASSERT_TRUE (BIN::to_size (bin, offset) == 5);
+	ASSERT_TRUE (bin_to_hwid (bin, offset) == 1);
+}
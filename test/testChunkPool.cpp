@@ -0,0 +1,106 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#include <gtest/gtest.h>
+
+using namespace shaga;
+
+TEST (ChunkPool, recycle)
+{
+	ChunkPool pool (4);
+
+	const char *payload_ptr {nullptr};
+	{
+		auto chunk = pool.get (1, "ABCD");
+		chunk->set_payload (std::string (1000, 'x'));
+		chunk->meta.add_uint32 ("CNT", 5);
+		payload_ptr = chunk->get_payload ().data ();
+	}
+	ASSERT_TRUE (pool.size () == 1);
+	ASSERT_TRUE (pool.get_allocations () == 1);
+
+	/* Recycled chunk is reset, but keeps its memory */
+	auto chunk = pool.get (2, "EFGH");
+	ASSERT_TRUE (pool.size () == 0);
+	ASSERT_TRUE (pool.get_allocations () == 1);
+	ASSERT_TRUE (chunk->get_source_hwid () == 2);
+	ASSERT_TRUE (chunk->get_type () == "EFGH");
+	ASSERT_FALSE (chunk->has_payload ());
+	ASSERT_TRUE (chunk->meta.empty ());
+	ASSERT_TRUE (chunk->get_prio () == Chunk::Priority::pMANDATORY);
+
+	const std::string data (500, 'y');
+	chunk->set_payload (std::string_view (data));
+	ASSERT_TRUE (chunk->get_payload ().data () == payload_ptr);
+
+	/* Handle may outlive the pool */
+	{
+		ChunkPool tmp;
+		chunk = tmp.get (3, "IJKL");
+	}
+	chunk.reset ();
+}
+
+TEST (ChunkPool, steady_state)
+{
+	ChunkPool pool (16);
+	ChunkTool tool;
+
+	CHUNKLIST lst;
+	for (size_t i = 0; i < 8; ++i) {
+		Chunk &chunk = lst.emplace_back (static_cast<HWID> (i), "ABCD");
+		chunk.set_payload (std::string (100 + i, 'a'));
+		chunk.meta.add_uint8 ("VAL", static_cast<uint8_t> (i));
+	}
+	const std::string bin = tool.to_bin (lst);
+
+	for (size_t loop = 0; loop < 10; ++loop) {
+		std::vector<ChunkPool::Handle> decoded;
+		size_t offset {0};
+		while (offset < bin.size ()) {
+			decoded.push_back (pool.get (bin, offset));
+		}
+
+		ASSERT_TRUE (decoded.size () == 8);
+		for (size_t i = 0; i < decoded.size (); ++i) {
+			ASSERT_TRUE (decoded[i]->get_source_hwid () == i);
+			ASSERT_TRUE (decoded[i]->get_payload ().size () == 100 + i);
+			ASSERT_TRUE (decoded[i]->meta.get_uint8 ("VAL", UINT8_MAX) == i);
+		}
+	}
+
+	/* Only the first loop allocated */
+	ASSERT_TRUE (pool.get_allocations () == 8);
+	ASSERT_TRUE (pool.size () == 8);
+
+	/* Broken data don't leak the chunk */
+	size_t offset {0};
+	ASSERT_THROW (pool.get (std::string_view (bin).substr (0, 20), offset), CommonException);
+	ASSERT_TRUE (pool.size () == 8);
+
+	pool.recycle (Chunk (1, "ABCD"));
+	ASSERT_TRUE (pool.size () == 9);
+
+	pool.clear ();
+	ASSERT_TRUE (pool.size () == 0);
+}
+
+TEST (ChunkPool, limits)
+{
+	ChunkPool pool (2, 256);
+
+	{
+		auto a = pool.get (1, "ABCD");
+		auto b = pool.get (1, "ABCD");
+		auto c = pool.get (1, "ABCD");
+		c->set_payload (std::string (1000, 'x'));
+	}
+
+	/* Large chunk was dropped, pool keeps at most 2 chunks */
+	ASSERT_TRUE (pool.size () == 2);
+	ASSERT_TRUE (pool.get_allocations () == 3);
+}
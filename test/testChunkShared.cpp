@@ -0,0 +1,92 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#include <gtest/gtest.h>
+
+using namespace shaga;
+
+TEST (ChunkShared, fanout)
+{
+	Chunk chunk (1, "ABCD", Chunk::Priority::pOPTIONAL);
+	chunk.set_payload (std::string (1000, 'x'));
+	chunk.set_json ({{"id", 5}, {"name", "test"}});
+	chunk.meta.add_uint32 ("CNT", 5);
+	chunk.meta.add_value ("NAM", "abc"sv);
+	chunk.meta.add_uint8 ("AAA", 1);
+	chunk.set_destination_broadcast ();
+
+	const ChunkShared shared (chunk);
+	ASSERT_TRUE (shared.use_count () == 1);
+	ASSERT_TRUE (shared.to_bin () == chunk.to_bin ());
+	ASSERT_TRUE (shared.to_chunk ().to_bin () == chunk.to_bin ());
+	ASSERT_TRUE (shared.get_payload () == chunk.get_payload ());
+	ASSERT_TRUE (shared.get_json () == chunk.get_json ());
+	ASSERT_TRUE (shared.get_meta ().get_uint32 ("CNT", 0) == 5);
+
+	std::vector<ChunkShared> copies;
+	for (HWID hwid = 10; hwid < 20; ++hwid) {
+		ChunkShared &copy = copies.emplace_back (shared);
+		copy.set_destination_hwid (hwid);
+		copy.set_ttl (static_cast<uint8_t> (hwid - 10));
+		copy.set_prio (Chunk::Priority::pCRITICAL);
+	}
+	ASSERT_TRUE (shared.use_count () == 11);
+
+	/* Only header differs, body is shared */
+	for (HWID hwid = 10; hwid < 20; ++hwid) {
+		const ChunkShared &copy = copies[hwid - 10];
+		ASSERT_TRUE (copy.get_payload ().data () == shared.get_payload ().data ());
+		ASSERT_TRUE (copy.is_for_destination (hwid));
+		ASSERT_FALSE (copy.is_for_destination (hwid + 1));
+
+		Chunk expected (chunk);
+		expected.set_destination_hwid (hwid);
+		expected.set_ttl (static_cast<uint8_t> (hwid - 10));
+		expected.set_prio (Chunk::Priority::pCRITICAL);
+
+		const std::string bin = copy.to_bin ();
+		ASSERT_TRUE (bin == expected.to_bin ());
+		ASSERT_TRUE (bin.size () <= copy.get_max_bytes ());
+
+		size_t offset {0};
+		const Chunk decoded (bin, offset);
+		ASSERT_TRUE (offset == bin.size ());
+		ASSERT_TRUE (decoded.to_bin () == bin);
+		ASSERT_TRUE (decoded.get_ttl () == copy.get_ttl ());
+		ASSERT_TRUE (decoded.meta.get_value ("NAM") == "abc"sv);
+	}
+	ASSERT_TRUE (shared.is_for_destination (10));
+	ASSERT_TRUE (shared.get_prio () == Chunk::Priority::pOPTIONAL);
+
+	copies.clear ();
+	ASSERT_TRUE (shared.use_count () == 1);
+}
+
+TEST (ChunkShared, tracert_special_types)
+{
+	const auto key = ChKEY ("ABCD");
+
+	Chunk::SPECIAL_TYPES special_types;
+	std::iota (special_types.begin (), special_types.end (), key);
+
+	for (const uint32_t type : {key, key + 1, Chunk::key_type_tracert}) {
+		Chunk chunk (2, type);
+		chunk.meta.add_uint16 ("VAL", 7);
+
+		ChunkShared shared (chunk);
+		ASSERT_FALSE (shared.has_payload ());
+		ASSERT_FALSE (shared.has_cbor ());
+		ASSERT_TRUE (shared.get_cbor ().empty ());
+
+		for (HWID hwid = 0; hwid < 3; ++hwid) {
+			ASSERT_TRUE (chunk.tracert_hops_add (hwid, static_cast<uint8_t> (hwid)) == shared.tracert_hops_add (hwid, static_cast<uint8_t> (hwid)));
+			ASSERT_TRUE (shared.to_bin (&special_types) == chunk.to_bin (&special_types));
+			ASSERT_TRUE (shared.to_bin () == chunk.to_bin ());
+		}
+		ASSERT_TRUE (shared.tracert_hops_get ().size () == chunk.tracert_hops_count ());
+	}
+}
@@ -0,0 +1,163 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#include <gtest/gtest.h>
+
+using namespace shaga;
+
+TEST (ChunkSpecialTypes, switch)
+{
+	ChunkSpecialTypes sender (16);
+	ChunkSpecialTypes receiver (16);
+
+	CHUNKLIST lst;
+	for (size_t i = 0; i < 100; ++i) {
+		lst.emplace_back (1, "ABCD", Chunk::Priority::pMANDATORY);
+		if ((i % 2) == 0) {
+			lst.emplace_back (1, "EFGH", Chunk::Priority::pMANDATORY);
+		}
+		if ((i % 50) == 0) {
+			lst.emplace_back (1, "IJKL", Chunk::Priority::pMANDATORY);
+		}
+	}
+	sender.count_all (lst);
+
+	/* Before the switch, nothing is special */
+	std::string bin;
+	for (const auto &chunk : lst) {
+		chunk.to_bin (bin, sender.get ());
+	}
+	const size_t size_before = bin.size ();
+
+	ASSERT_TRUE (sender.propose (2));
+	ASSERT_TRUE (sender.is_pending ());
+
+	/* Until commit, chunks are still serialized with the old table */
+	ASSERT_TRUE (sender.get_epoch () == 0);
+	for (const auto &chunk : lst) {
+		chunk.to_bin (bin, sender.get ());
+	}
+	ASSERT_TRUE (bin.size () == (size_before * 2));
+
+	/* Control chunk goes first, then the chunks using the new table */
+	sender.to_bin (lst, bin);
+	ASSERT_FALSE (sender.is_pending ());
+	ASSERT_TRUE (sender.get_epoch () == 1);
+
+	size_t offset = size_before * 2;
+	const Chunk ctrl (bin, offset);
+	ASSERT_TRUE (ctrl.get_num_type () == ChunkSpecialTypes::key_type_control);
+	ASSERT_TRUE (ctrl.get_prio () == Chunk::Priority::pCRITICAL);
+	const size_t size_ctrl = offset;
+
+	/* Every chunk after the switch saves 2 bytes */
+	ASSERT_TRUE ((bin.size () - size_ctrl) == (size_before - (lst.size () * 2)));
+
+	/* Same traffic again doesn't change the table */
+	sender.count_all (lst);
+	ASSERT_FALSE (sender.propose (2));
+	ASSERT_FALSE (sender.commit (bin));
+	ASSERT_TRUE (sender.get_epoch () == 1);
+
+	CHUNKLIST decoded;
+	offset = 0;
+	ASSERT_NO_THROW (receiver.from_bin (bin, offset, decoded));
+	ASSERT_TRUE (offset == bin.size ());
+	ASSERT_TRUE (receiver.get_epoch () == 1);
+	ASSERT_TRUE (*receiver.get () == *sender.get ());
+
+	ASSERT_TRUE (decoded.size () == lst.size () * 3);
+	auto iter = decoded.cbegin ();
+	for (size_t i = 0; i < 3; ++i) {
+		for (const auto &chunk : lst) {
+			ASSERT_TRUE (iter->get_num_type () == chunk.get_num_type ());
+			++iter;
+		}
+	}
+
+	/* Repeated control chunk has wrong epoch */
+	ASSERT_THROW (receiver.apply (ctrl), CommonException);
+}
+
+TEST (ChunkSpecialTypes, adapt)
+{
+	ChunkSpecialTypes sender (16);
+	ChunkSpecialTypes receiver (16);
+
+	sender.count (ChKEY ("ABCD"), 1000);
+	sender.count (Chunk::key_type_tracert, 1000);
+	ASSERT_TRUE (sender.propose (1));
+
+	std::string ctrl_bin;
+	ASSERT_TRUE (sender.commit (ctrl_bin));
+	size_t offset {0};
+	ASSERT_TRUE (receiver.apply (Chunk (ctrl_bin, offset)));
+
+	/* TRAC has its own short header */
+	ASSERT_TRUE (std::count (sender.get ()->cbegin (), sender.get ()->cend (), Chunk::key_type_tracert) == 0);
+
+	/* Traffic changes, old type keeps its position */
+	bool proposed {false};
+	for (size_t i = 0; i < 10 && proposed == false; ++i) {
+		sender.count (ChKEY ("ABCD"), 100);
+		sender.count (ChKEY ("BCDE"), 1000);
+		proposed = sender.propose (1);
+	}
+	ASSERT_TRUE (proposed);
+	ASSERT_TRUE (sender.get_epoch () == 1);
+
+	ctrl_bin.clear ();
+	ASSERT_TRUE (sender.commit (ctrl_bin));
+	ASSERT_TRUE (sender.get_epoch () == 2);
+	ASSERT_TRUE ((*sender.get ())[0] == ChKEY ("ABCD"));
+	ASSERT_TRUE ((*sender.get ())[1] == ChKEY ("BCDE"));
+
+	std::string bin;
+	sender.to_bin (Chunk (1, "BCDE"), bin);
+
+	/* Receiver doesn't know the type yet */
+	offset = 0;
+	ASSERT_THROW (Chunk (bin, offset, receiver.get ()), CommonException);
+
+	offset = 0;
+	ASSERT_TRUE (receiver.apply (ChunkView (ctrl_bin, offset)));
+
+	offset = 0;
+	const Chunk decoded (bin, offset, receiver.get ());
+	ASSERT_TRUE (decoded.get_num_type () == ChKEY ("BCDE"));
+	ASSERT_FALSE (receiver.apply (decoded));
+
+	/* Corrupted control chunk */
+	offset = 0;
+	Chunk bad (ctrl_bin, offset);
+	bad.set_payload ("short"sv);
+	ASSERT_THROW (receiver.apply (bad), CommonException);
+}
+
+TEST (ChunkSpecialTypes, priority_order)
+{
+	ChunkSpecialTypes sender (16);
+	ChunkSpecialTypes receiver (16);
+
+	/* Older critical chunk sorts before the control chunk proposed later */
+	ChunkPrioSet set;
+	set.insert (Chunk (1, "ABCD", Chunk::Priority::pCRITICAL));
+
+	sender.count (ChKEY ("ABCD"), 1000);
+	ASSERT_TRUE (sender.propose (1));
+	set.insert (Chunk (1, "ABCD", Chunk::Priority::pMANDATORY));
+
+	std::string bin;
+	sender.to_bin (set, bin);
+
+	CHUNKLIST decoded;
+	size_t offset {0};
+	ASSERT_NO_THROW (receiver.from_bin (bin, offset, decoded));
+	ASSERT_TRUE (offset == bin.size ());
+	ASSERT_TRUE (decoded.size () == set.size ());
+	ASSERT_TRUE (receiver.get_epoch () == sender.get_epoch ());
+}
@@ -226,3 +226,243 @@ TEST (ChunkTool, MaxSizeHandling)
 	EXPECT_TRUE(bin1.size() < bin2.size());
 	EXPECT_TRUE(bin2.size() <= bin3.size());
 }
+
+TEST (ChunkTool, contiguous_containers)
+{
+	const size_t sze = 500;
+	std::vector<Chunk> v;
+
+	for (size_t i = 0; i < sze; ++i) {
+		v.emplace_back (i % 7, "AAAA", Chunk::Priority::pCRITICAL);
+		v.emplace_back (i % 5, "BBBB", Chunk::Priority::pMANDATORY, "payload"sv);
+		v.emplace_back (i % 3, "CCCC", Chunk::Priority::pOPTIONAL);
+		v.emplace_back (i % 11, "DDDD", Chunk::Priority::pDEBUG);
+	}
+
+	std::random_device rd;
+	std::mt19937 rng (rd ());
+	std::shuffle (v.begin (), v.end (), rng);
+
+	CHUNKSET cset;
+	ChunkPrioSet pset;
+	CHUNKLIST lst;
+	CHUNKDEQUE deq;
+	for (const auto &c : v) {
+		cset.insert (c);
+		pset.insert (c);
+		lst.push_back (c);
+		deq.push_back (c);
+	}
+
+	ASSERT_TRUE (pset.size () == cset.size ());
+	EXPECT_TRUE (std::equal (cset.begin (), cset.end (), pset.begin (), pset.end ()));
+
+	/* Limited size would throw once mandatory chunks don't fit */
+	ChunkTool tool (false, nullptr);
+
+	/* Same output and same content left, including skipped chunks */
+	while (cset.empty () == false) {
+		const std::string a = tool.to_bin (cset, 1000, Chunk::Priority::pOPTIONAL);
+		const std::string b = tool.to_bin (pset, 1000, Chunk::Priority::pOPTIONAL);
+		EXPECT_TRUE (a == b);
+		ASSERT_TRUE (cset.size () == pset.size ());
+		if (a.empty () == true) {
+			break;
+		}
+	}
+	EXPECT_TRUE (pset.size () == sze);
+
+	for (const bool erase_skipped : {false, true}) {
+		CHUNKLIST l = lst;
+		CHUNKDEQUE d = deq;
+		while (l.empty () == false) {
+			const std::string a = tool.to_bin (l, 1000, Chunk::Priority::pMANDATORY, erase_skipped);
+			const std::string b = tool.to_bin (d, 1000, Chunk::Priority::pMANDATORY, erase_skipped);
+			EXPECT_TRUE (a == b);
+			ASSERT_TRUE (l.size () == d.size ());
+			ASSERT_TRUE (std::equal (l.begin (), l.end (), d.begin (), d.end ()));
+			if (a.empty () == true) {
+				break;
+			}
+		}
+		EXPECT_TRUE (d.size () == ((true == erase_skipped) ? 0 : sze * 2));
+	}
+
+	/* Decode */
+	std::string bin;
+	CHUNKLIST l = lst;
+	tool.to_bin (l, bin);
+	auto pset2 = tool.from_bin<ChunkPrioSet> (bin);
+	const auto deq2 = tool.from_bin<CHUNKDEQUE> (bin);
+	EXPECT_TRUE (pset2.size () == sze * 4);
+	EXPECT_TRUE (deq2.size () == sze * 4);
+	EXPECT_TRUE (pset2.bucket (Chunk::Priority::pOPTIONAL).size () == sze);
+
+	/* Trim */
+	for (const auto prio : {Chunk::Priority::pCRITICAL, Chunk::Priority::pOPTIONAL, Chunk::Priority::pDEBUG}) {
+		for (const size_t treshold : {size_t (0), sze, sze * 3 + 10, sze * 5}) {
+			CHUNKSET cs;
+			ChunkPrioSet ps;
+			for (const auto &c : v) {
+				cs.insert (c);
+				ps.insert (c);
+			}
+
+			ChunkTool::trim (cs, treshold, prio);
+			ChunkTool::trim (ps, treshold, prio);
+			ASSERT_TRUE (cs.size () == ps.size ());
+			EXPECT_TRUE (std::equal (cs.begin (), cs.end (), ps.begin (), ps.end ()));
+		}
+	}
+
+	/* Purge */
+	ChunkTool::purge (pset2, [](const Chunk &chunk) -> bool { return chunk.get_source_hwid () == 1; });
+	EXPECT_TRUE (std::all_of (pset2.begin (), pset2.end (), [](const Chunk &chunk) -> bool { return chunk.get_source_hwid () == 1; }));
+	EXPECT_FALSE (pset2.empty ());
+
+	ChunkTool::change_source_hwid (deq, 9, false);
+	EXPECT_TRUE (std::all_of (deq.begin (), deq.end (), [](const Chunk &chunk) -> bool { return chunk.get_source_hwid () == 9; }));
+}
+
+TEST (ChunkTool, prio_queue)
+{
+	const size_t sze = 1000;
+	ChunkPrioQueue queue;
+
+	EXPECT_THROW (queue.front (), CommonException);
+	EXPECT_THROW (queue.pop_front (), CommonException);
+
+	for (size_t i = 0; i < sze; ++i) {
+		queue.emplace (i, "DDDD", Chunk::Priority::pDEBUG);
+		queue.emplace (i, "CCCC", Chunk::Priority::pOPTIONAL);
+		queue.emplace (i, "BBBB", Chunk::Priority::pMANDATORY);
+		queue.emplace (i, "AAAA", Chunk::Priority::pCRITICAL);
+	}
+
+	ASSERT_TRUE (queue.size () == sze * 4);
+
+	/* Highest priority first, FIFO inside priority */
+	EXPECT_TRUE (queue.front ().get_prio () == Chunk::Priority::pCRITICAL);
+	EXPECT_TRUE (queue.front ().get_source_hwid () == 0);
+	queue.pop_front ();
+	EXPECT_TRUE (queue.front ().get_source_hwid () == 1);
+
+	Chunk::Priority last_prio {Chunk::Priority::pCRITICAL};
+	HWID last_hwid {0};
+	for (const Chunk &chunk : queue) {
+		if (chunk.get_prio () == last_prio) {
+			EXPECT_TRUE (chunk.get_source_hwid () > last_hwid || (chunk.get_source_hwid () == 0 && last_prio != Chunk::Priority::pCRITICAL));
+		}
+		else {
+			EXPECT_TRUE (chunk.get_prio () > last_prio);
+		}
+		last_prio = chunk.get_prio ();
+		last_hwid = chunk.get_source_hwid ();
+	}
+
+	/* Trim drops tails of lowest buckets */
+	ChunkTool::trim (queue, sze * 2 + 10, Chunk::Priority::pOPTIONAL);
+	EXPECT_TRUE (queue.size () == sze * 2 + 10);
+	EXPECT_TRUE (queue.bucket_size (Chunk::Priority::pDEBUG) == 0);
+	EXPECT_TRUE (queue.bucket_size (Chunk::Priority::pOPTIONAL) == 11);
+	EXPECT_TRUE (queue.bucket (Chunk::Priority::pOPTIONAL).back ().get_source_hwid () == 10);
+
+	ChunkTool::trim (queue, 0, Chunk::Priority::pMANDATORY);
+	EXPECT_TRUE (queue.size () == sze - 1);
+
+	/* Binary is in the same order as the queue */
+	ChunkTool tool (false, nullptr);
+	queue.emplace (5, "EEEE", Chunk::Priority::pDEBUG);
+	const std::string bin = tool.to_bin (queue, 0, Chunk::Priority::pOPTIONAL);
+	EXPECT_TRUE (queue.size () == 1);
+
+	const auto lst = tool.from_bin<CHUNKLIST> (bin);
+	ASSERT_TRUE (lst.size () == sze - 1);
+	EXPECT_TRUE (lst.front ().get_source_hwid () == 1);
+	EXPECT_TRUE (lst.back ().get_source_hwid () == sze - 1);
+
+	auto queue2 = tool.from_bin<ChunkPrioQueue> (bin);
+	EXPECT_TRUE (queue2.size () == sze - 1);
+	ChunkTool::purge (queue2, [](const Chunk &chunk) -> bool { return (chunk.get_source_hwid () % 2) == 0; });
+	EXPECT_TRUE (queue2.size () == (sze - 1) / 2);
+}
+
+TEST (ChunkTool, to_bin_truncate)
+{
+	CHUNKLIST lst;
+	for (size_t i = 0; i < 10; ++i) {
+		lst.emplace_back (i, "AAAA", Chunk::Priority::pOPTIONAL, std::string (100, 'x'));
+	}
+
+	const size_t chunk_size = lst.front ().to_bin ().size ();
+
+	/* Output is appended to existing data and limit applies only to appended part */
+	ChunkTool tool (true, nullptr);
+	std::string out ("prefix");
+	tool.to_bin (lst, out, (chunk_size * 3) + (chunk_size / 2));
+	EXPECT_EQ (out.size (), 6 + (chunk_size * 3));
+	EXPECT_EQ (out.substr (0, 6), "prefix");
+	EXPECT_EQ (lst.size (), 7u);
+
+	const auto decoded = tool.from_bin<CHUNKLIST> (std::string_view (out).substr (6));
+	ASSERT_EQ (decoded.size (), 3u);
+	EXPECT_EQ (decoded.back ().get_source_hwid (), 2u);
+
+	/* First chunk doesn't fit, output is not modified */
+	EXPECT_THROW (tool.to_bin (lst, out, chunk_size - 1), CommonException);
+	EXPECT_EQ (out.size (), 6 + (chunk_size * 3));
+	EXPECT_EQ (lst.size (), 7u);
+}
+
+TEST (ChunkTool, from_bin_parallel)
+{
+	const Chunk::SPECIAL_TYPES special_types { ChKEY ("AAAA"), 0, 0, 0, 0, 0, 0 };
+	ChunkTool tool (false, &special_types);
+
+	CHUNKLIST lst;
+	for (uint32_t i = 0; i < 5000; ++i) {
+		lst.emplace_back (i, (i % 3) ? "AAAA" : "ABCD", uint8_to_priority (i % 4), std::string (i % 50, 'x'));
+		if (i % 7 == 0) {
+			lst.back ().meta.add_uint32 ("NUM", i);
+		}
+	}
+
+	const std::string bin = tool.to_bin (lst);
+
+	size_t offset {0};
+	CHUNKSET sequential;
+	tool.from_bin (bin, offset, sequential);
+
+	for (const size_t threads : {1, 3, 8}) {
+		offset = 0;
+		std::vector<Chunk> vec;
+		vec.emplace_back (0, "ZZZZ");
+		tool.from_bin_parallel (bin, offset, vec, threads);
+		EXPECT_TRUE (offset == bin.size ());
+		ASSERT_TRUE (vec.size () == sequential.size () + 1);
+
+		/* Chunks are in original order */
+		std::string out;
+		for (size_t i = 1; i < vec.size (); ++i) {
+			vec[i].to_bin (out, &special_types);
+		}
+		EXPECT_TRUE (out == bin);
+
+		/* Counters are in the same order as with sequential decoding */
+		CHUNKSET cset (vec.begin () + 1, vec.end ());
+		CHUNKSET seq_copy (sequential);
+		EXPECT_TRUE (tool.to_bin (cset) == tool.to_bin (seq_copy));
+	}
+
+	/* Error keeps output untouched */
+	std::string broken = bin;
+	broken.resize (bin.size () - 1);
+	offset = 0;
+	CHUNKDEQUE deq;
+	EXPECT_ANY_THROW (tool.from_bin_parallel (broken, offset, deq, 4));
+	EXPECT_TRUE (offset == 0);
+	EXPECT_TRUE (deq.empty ());
+
+	tool.from_bin_parallel (bin, offset, deq, 4);
+	EXPECT_TRUE (deq.size () == sequential.size ());
+}
@@ -0,0 +1,204 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#include <gtest/gtest.h>
+
+using namespace shaga;
+
+TEST (ChunkView, parse)
+{
+	const auto data = "{ \"happy\": true, \"pi\": 3.141 }"_json;
+	const Chunk::SPECIAL_TYPES special_types { ChKEY ("AAAA"), ChKEY ("BBBB"), 0, 0, 0, 0, 0 };
+
+	ChunkMeta meta;
+	meta.add_value ("ABC", "abc"sv);
+	meta.add_value ("ABC", "def"sv);
+	meta.add_uint32 ("XYZ", 0x12345678);
+
+	CHUNKLIST lst;
+	lst.emplace_back (1, "AAAA", Chunk::Priority::pCRITICAL, "payload"sv);
+	lst.emplace_back (2, "ABCD", Chunk::TrustLevel::FRIEND, Chunk::TTL::TTL3, Chunk::Channel::SECONDARY, data);
+	lst.emplace_back (3, "BBBB", HWIDMASK (0x1200, 0xFF00), meta, "payload"sv, data);
+	lst.emplace_back (4, "TRAC", Chunk::Priority::pDEBUG, meta);
+	lst.back ().tracert_hops_add (10, 1);
+	lst.back ().tracert_hops_add (11, 2);
+
+	const std::vector<Chunk> orig (lst.begin (), lst.end ());
+
+	ChunkTool tool (&special_types);
+	const std::string bin = tool.to_bin (lst);
+
+	CHUNKVIEWS views;
+	size_t offset {0};
+	tool.from_bin (bin, offset, views);
+	ASSERT_TRUE (views.size () == orig.size ());
+
+	size_t total {0};
+	for (size_t id = 0; id < views.size (); ++id) {
+		const ChunkView &v = views[id];
+		const Chunk &c = orig[id];
+
+		EXPECT_TRUE (v.get_source_hwid () == c.get_source_hwid ());
+		EXPECT_TRUE (v.get_num_type () == c.get_num_type ());
+		EXPECT_TRUE (v.get_type () == c.get_type ());
+		EXPECT_TRUE (v.get_prio () == c.get_prio ());
+		EXPECT_TRUE (v.get_trustlevel () == c.get_trustlevel ());
+		EXPECT_TRUE (v.get_ttl () == c.get_ttl ());
+		EXPECT_TRUE (v.get_channel () == c.get_channel ());
+		EXPECT_TRUE (v.get_destination_hwidmask () == c.get_destination_hwidmask ());
+		EXPECT_TRUE (v.get_payload () == c.get_payload ());
+		EXPECT_TRUE (v.has_cbor () == c.has_cbor ());
+		EXPECT_TRUE (v.tracert_hops_count () == c.tracert_hops_count ());
+
+		if (v.has_cbor () == true) {
+			EXPECT_TRUE (v.get_json () == data);
+		}
+
+		/* Views point to the source buffer */
+		EXPECT_TRUE (v.get_binary ().data () == bin.data () + total);
+		total += v.get_binary ().size ();
+
+		/* Full decode */
+		const Chunk full = v.to_chunk ();
+		EXPECT_TRUE (full.get_payload () == c.get_payload ());
+		EXPECT_TRUE (full.meta.size () == c.meta.size ());
+	}
+	EXPECT_TRUE (total == bin.size ());
+
+	EXPECT_TRUE (views[2].is_for_destination (0x1234));
+	EXPECT_FALSE (views[2].is_for_destination (0x1334));
+	EXPECT_TRUE (views[0].is_for_destination (0x1334));
+
+	EXPECT_TRUE (views[3].tracert_hop (1).hwid == 11);
+	EXPECT_TRUE (views[3].tracert_hop (1).metric == 2);
+	EXPECT_THROW (views[3].tracert_hop (2), CommonException);
+
+	/* Meta is decoded only when requested */
+	EXPECT_FALSE (views[0].has_meta ());
+	EXPECT_TRUE (views[2].has_meta ());
+	EXPECT_TRUE (views[2].get_meta ().size () == 3);
+	EXPECT_TRUE (views[2].get_meta ().get_uint32 ("XYZ", 0) == 0x12345678);
+	EXPECT_TRUE (views[2].get_meta_value ("XYZ").has_value ());
+	EXPECT_FALSE (views[2].get_meta_value ("XXX").has_value ());
+	EXPECT_FALSE (views[0].get_meta_value ("ABC").has_value ());
+
+	const auto abc = views[3].get_meta_value ("ABC");
+	ASSERT_TRUE (abc.has_value ());
+	EXPECT_TRUE (*abc == "abc" || *abc == "def");
+}
+
+TEST (ChunkView, malformed)
+{
+	const std::string bin = Chunk (1, "ABCD", "payload"sv).to_bin ();
+
+	for (size_t len = 0; len < bin.size (); ++len) {
+		size_t offset {0};
+		EXPECT_ANY_THROW (ChunkView (std::string_view (bin).substr (0, len), offset));
+	}
+
+	/* Special type without special_types */
+	const Chunk::SPECIAL_TYPES special_types { ChKEY ("ABCD"), 0, 0, 0, 0, 0, 0 };
+	const std::string special = Chunk (1, "ABCD").to_bin (&special_types);
+	size_t offset {0};
+	EXPECT_THROW (ChunkView (special, offset), CommonException);
+	offset = 0;
+	EXPECT_NO_THROW (ChunkView (special, offset, &special_types));
+}
+
+TEST (ChunkView, batch)
+{
+	ChunkTool tool;
+	CHUNKLIST lst;
+	lst.emplace_back (1, "ABCD", "first"sv);
+	lst.emplace_back (2, "EFGH", "second"sv);
+	lst.emplace_back (3, "IJKL");
+
+	std::string bin;
+	tool.to_bin (lst, bin);
+
+	ChunkBatch batch;
+	tool.from_bin (bin, batch);
+	ASSERT_TRUE (batch.size () == 3);
+	EXPECT_TRUE (batch[0].get_payload () == "first");
+	EXPECT_TRUE (batch[1].get_type () == "EFGH");
+	EXPECT_FALSE (batch[2].has_payload ());
+
+	/* Views reference the arena, not the source buffer */
+	const std::string_view arena = batch.get_binary ();
+	EXPECT_TRUE (arena.data () != bin.data ());
+	for (const auto &view : batch) {
+		EXPECT_TRUE (view.get_binary ().data () >= arena.data ());
+		EXPECT_TRUE (view.get_binary ().data () + view.get_binary ().size () <= arena.data () + arena.size ());
+	}
+
+	/* Decoding again replaces content */
+	tool.from_bin (std::string (bin.substr (0, batch[0].get_binary ().size ())), batch);
+	EXPECT_TRUE (batch.size () == 1);
+
+	/* Failed decode leaves batch empty */
+	EXPECT_ANY_THROW (tool.from_bin (bin.substr (0, bin.size () - 1), batch));
+	EXPECT_TRUE (batch.empty ());
+
+	batch.decode (bin);
+	EXPECT_TRUE (batch.size () == 3);
+	batch.reset ();
+	EXPECT_TRUE (batch.empty ());
+	EXPECT_TRUE (batch.get_binary ().empty ());
+}
+
+TEST (ChunkView, forward)
+{
+	const Chunk::SPECIAL_TYPES special_types { ChKEY ("AAAA"), 0, 0, 0, 0, 0, 0 };
+
+	ChunkMeta meta;
+	meta.add_value ("ABC", "abc"sv);
+
+	CHUNKLIST lst;
+	lst.emplace_back (1, "AAAA", Chunk::Priority::pCRITICAL, "payload"sv);
+	lst.emplace_back (2, "ABCD", Chunk::TrustLevel::FRIEND, Chunk::TTL::TTL3, Chunk::Channel::SECONDARY, meta);
+	lst.emplace_back (3, "BBBB", Chunk::TTL::TTL0, HWIDMASK (0x1200, 0xFF00), "payload"sv);
+	lst.emplace_back (4, "TRAC", Chunk::Priority::pDEBUG, meta);
+	lst.back ().tracert_hops_add (10, 1);
+
+	ChunkTool tool (&special_types);
+
+	/* Expected result is the same as full decode, hop_ttl () and change of source */
+	CHUNKLIST expected;
+	for (Chunk c : lst) {
+		if (c.hop_ttl () == true) {
+			expected.push_back (std::move (c));
+		}
+	}
+	tool.change_source_hwid (expected, 0xABCD, false);
+	ASSERT_TRUE (expected.size () == 3);
+
+	std::string bin = tool.to_bin (lst);
+
+	std::string out;
+	size_t offset {0};
+	while (offset < bin.size ()) {
+		const size_t start {offset};
+		const std::string_view fwd = ChunkView::forward (bin, offset, 0xABCD, &special_types);
+		EXPECT_TRUE (offset > start);
+		if (fwd.empty () == false) {
+			EXPECT_TRUE (fwd.data () == bin.data () + start);
+			out.append (fwd);
+		}
+	}
+	EXPECT_TRUE (offset == bin.size ());
+	EXPECT_TRUE (out == tool.to_bin (expected));
+
+	/* Without new source, only TTL changes */
+	std::string single = Chunk (5, "ABCD", Chunk::TTL::TTL2, "payload"sv).to_bin ();
+	offset = 0;
+	ChunkView::forward (single, offset, std::nullopt);
+	offset = 0;
+	const Chunk c (single, offset);
+	EXPECT_TRUE (c.get_ttl () == 1);
+	EXPECT_TRUE (c.get_source_hwid () == 5);
+	EXPECT_TRUE (c.get_payload () == "payload"sv);
+}
@@ -0,0 +1,123 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#include <gtest/gtest.h>
+
+using namespace shaga;
+
+#if defined(OS_LINUX) && defined(SHAGA_COROUTINES)
+
+typedef PacketEncodeSPSC<SPSCDataDynAlloc> CoEncoder;
+typedef PacketDecodeSPSC<SPSCDataDynAlloc> CoDecoder;
+
+static CoTask _co_reader (CoScheduler &sched, CoDecoder &decoder, std::vector<std::string> &out, const size_t count)
+{
+	for (size_t i = 0; i < count; ++i) {
+		out.push_back (co_await sched.next (decoder));
+	}
+}
+
+static CoTask _co_writer (CoScheduler &sched, CoEncoder &encoder, CoDecoder &decoder)
+{
+	char buffer[256];
+
+	co_await sched.writable (encoder);
+
+	while (encoder.empty () == false) {
+		const size_t len = encoder.fill_front_buffer (buffer, sizeof (buffer));
+		encoder.move_front_buffer (len);
+		decoder.push_buffer (buffer, len);
+	}
+}
+
+static CoTask _co_failing (CoScheduler &sched, CoDecoder &decoder)
+{
+	co_await sched.next (decoder);
+	cThrow ("Task failed"sv);
+}
+
+TEST (CoSPSC, next_writable)
+{
+	const size_t count = 32;
+
+	CoScheduler sched;
+	CoEncoder encoder (64, count + 1);
+	CoDecoder decoder (64, count + 1);
+
+	std::vector<std::string> received;
+
+	sched.spawn (_co_reader (sched, decoder, received, count));
+	sched.spawn (_co_writer (sched, encoder, decoder));
+	EXPECT_TRUE (sched.get_task_count () == 2);
+
+	/* Nothing to do yet */
+	EXPECT_TRUE (sched.run_once (0) == 0);
+
+	for (size_t i = 0; i < count; ++i) {
+		encoder.push_buffer (fmt::format ("packet {}"sv, i));
+	}
+
+	sched.run ();
+	EXPECT_TRUE (sched.get_task_count () == 0);
+
+	ASSERT_TRUE (received.size () == count);
+	for (size_t i = 0; i < count; ++i) {
+		EXPECT_TRUE (received[i] == fmt::format ("packet {}"sv, i));
+	}
+}
+
+TEST (CoSPSC, errors)
+{
+	CoScheduler sched;
+	CoEncoder encoder (64, 4);
+	CoDecoder decoder (64, 4);
+
+	std::vector<std::string> received;
+
+	sched.spawn (_co_failing (sched, decoder));
+
+	/* Only one coroutine can wait on one SPSC */
+	EXPECT_THROW (sched.spawn (_co_reader (sched, decoder, received, 1)), CommonException);
+
+	encoder.push_buffer ("abcd"sv);
+	char buffer[64];
+	const size_t len = encoder.fill_front_buffer (buffer, sizeof (buffer));
+	decoder.push_buffer (buffer, len);
+
+	EXPECT_THROW (sched.run_once (-1), CommonException);
+	EXPECT_TRUE (sched.get_task_count () == 0);
+}
+
+TEST (CoSPSC, reused_descriptor)
+{
+	CoScheduler sched;
+
+	/* Links come and go, new eventfd usually gets number of the closed one */
+	for (const bool do_forget : {true, false, false}) {
+		auto encoder = std::make_unique<CoEncoder> (64, 4);
+		auto decoder = std::make_unique<CoDecoder> (64, 4);
+
+		std::vector<std::string> received;
+		sched.spawn (_co_reader (sched, *decoder, received, 1));
+		EXPECT_TRUE (sched.get_task_count () == 1);
+
+		encoder->push_buffer ("abcd"sv);
+		char buffer[64];
+		const size_t len = encoder->fill_front_buffer (buffer, sizeof (buffer));
+		decoder->push_buffer (buffer, len);
+
+		ASSERT_NO_THROW (sched.run ());
+		ASSERT_TRUE (received.size () == 1);
+		EXPECT_TRUE (received[0] == "abcd");
+
+		if (true == do_forget) {
+			sched.forget (*decoder);
+		}
+	}
+}
+
+#endif // OS_LINUX && SHAGA_COROUTINES
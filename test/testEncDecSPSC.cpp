@@ -604,6 +604,266 @@ static void _seqpacketspsc_test (void)
 	}
 }
 
+template<class T>
+static void _varpacketspsc_test (const bool crc)
+{
+	const size_t datasize = 256;
+	const size_t sze = 256;
+	const size_t loops = 16;
+	const size_t totalsize = datasize * sze;
+
+	VarPacketEncodeSPSC<T> encodering (datasize, sze + 1);
+	VarPacketDecodeSPSC<T> decodering (datasize, sze + 1);
+
+	encodering.has_crc32c (crc);
+	decodering.has_crc32c (crc);
+
+	char tempbuffer[600];
+	size_t pos;
+
+	uint8_t buffer[totalsize];
+
+	for (pos = 0; pos < totalsize; ++pos) {
+		buffer[pos] = pos & 0xff;
+	}
+
+	for (size_t loop = 0; loop < loops; ++loop) {
+		for (pos = 0; pos < totalsize; pos += datasize) {
+			ASSERT_NO_THROW (encodering.push_buffer (buffer, pos, pos + datasize));
+		}
+
+		/* Ring should be full at this point */
+		ASSERT_THROW (encodering.push_buffer (buffer, 0, 1), CommonException);
+
+		/* 2 bytes of size, 4 bytes of CRC */
+		ASSERT_TRUE (encodering.get_stored_bytes () == (sze * (datasize + 2 + (crc ? 4 : 0))));
+
+		/* Now lets fill tempbuffer with encoded data and push it to decodering */
+		pos = sze;
+		while (true) {
+			pos = (pos + 1) % sizeof (tempbuffer);
+			const size_t available = encodering.fill_front_buffer (tempbuffer, pos);
+			if (0 == available) {
+				if (0 == pos) {
+					/* We actually requested 0 bytes */
+					continue;
+				}
+				/* No more data */
+				break;
+			}
+
+			/* Push to decodering */
+			ASSERT_NO_THROW (decodering.push_buffer (tempbuffer, available));
+
+			/* Move read pointer */
+			ASSERT_NO_THROW (encodering.move_front_buffer (available));
+		}
+
+		ASSERT_TRUE (decodering.get_err_count_reset () == 0);
+
+		pos = 0;
+		while (true) {
+			std::string str;
+			if (decodering.pop_buffer (str) == false) {
+				break;
+			}
+
+			ASSERT_TRUE (str.size () == datasize);
+			ASSERT_TRUE (::memcmp (buffer + pos, str.data (), str.size ()) == 0);
+
+			pos += str.size ();
+		}
+
+		ASSERT_TRUE (pos == totalsize);
+	}
+}
+
+template<class T>
+static void _varpacket_sizes_test (const bool crc)
+{
+	const size_t datasize = 20000;
+	const size_t num = 64;
+
+	VarPacketEncodeSPSC<T> encodering (datasize, num + 1);
+	VarPacketDecodeSPSC<T> decodering (datasize, num + 1);
+
+	encodering.has_crc32c (crc);
+	decodering.has_crc32c (crc);
+
+	std::string buffer (datasize + 1, '\0');
+	for (size_t pos = 0; pos < buffer.size (); ++pos) {
+		buffer[pos] = pos & 0xff;
+	}
+
+	ASSERT_THROW (encodering.push_buffer (buffer), CommonException);
+
+	/* Sizes around 1, 2 and 3 byte boundaries of size encoding */
+	const std::vector<size_t> sizes {1, 2, 0x7F, 0x80, 0x81, 0x3FFF, 0x4000, 0x4001, datasize};
+	for (const size_t cursize : sizes) {
+		ASSERT_NO_THROW (encodering.push_buffer (buffer.data (), cursize));
+	}
+
+	std::string tempbuffer (encodering.get_stored_bytes (), '\0');
+	const size_t available = encodering.fill_front_buffer (tempbuffer.data (), tempbuffer.size ());
+	ASSERT_TRUE (available == tempbuffer.size ());
+	ASSERT_NO_THROW (encodering.move_front_buffer (available));
+
+	/* One byte at a time */
+	for (size_t pos = 0; pos < available; ++pos) {
+		ASSERT_NO_THROW (decodering.push_buffer (tempbuffer.data () + pos, 1));
+	}
+
+	std::string str;
+	for (const size_t cursize : sizes) {
+		ASSERT_TRUE (decodering.pop_buffer (str));
+		ASSERT_TRUE (str == std::string_view (buffer).substr (0, cursize));
+	}
+	ASSERT_FALSE (decodering.pop_buffer (str));
+	ASSERT_TRUE (decodering.get_err_count () == 0);
+
+	if (true == crc) {
+		/* Corrupted data has to be detected */
+		encodering.push_buffer (buffer.data (), 16);
+		const size_t len = encodering.fill_front_buffer (tempbuffer.data (), tempbuffer.size ());
+		encodering.move_front_buffer (len);
+
+		tempbuffer[5] ^= 0x01;
+		decodering.push_buffer (tempbuffer.data (), len);
+		ASSERT_FALSE (decodering.pop_buffer (str));
+		ASSERT_TRUE (decodering.get_err_count () == 1);
+	}
+}
+
+template<class T>
+static void _compression_test (const bool dict)
+{
+	const size_t datasize = 4096;
+	const size_t num = 32;
+
+	VarPacketEncodeSPSC<T> encodering (datasize + 1, num + 1);
+	VarPacketDecodeSPSC<T> decodering (datasize + 1, num + 1);
+
+	encodering.set_compression (true, dict);
+	decodering.set_compression (true, dict);
+
+	std::string buffer;
+	for (size_t pos = 0; buffer.size () < datasize; ++pos) {
+		buffer.append (fmt::format ("{} line of text {}\n"sv, pos, pos % 7));
+	}
+	buffer.resize (datasize);
+
+	for (size_t pos = 0; pos < num; ++pos) {
+		ASSERT_NO_THROW (encodering.push_buffer (buffer.data (), pos * (datasize / num), datasize));
+	}
+
+	/* Text should compress at least to half */
+	ASSERT_TRUE (encodering.get_stored_bytes () < ((datasize * num) / 4));
+
+	std::string tempbuffer (encodering.get_stored_bytes (), '\0');
+	const size_t available = encodering.fill_front_buffer (tempbuffer.data (), tempbuffer.size ());
+	ASSERT_NO_THROW (encodering.move_front_buffer (available));
+	ASSERT_NO_THROW (decodering.push_buffer (tempbuffer.data (), available));
+
+	std::string str;
+	for (size_t pos = 0; pos < num; ++pos) {
+		const std::string_view expected = std::string_view (buffer).substr (pos * (datasize / num));
+
+		/* Peek must return decompressed data, discarding pop must keep dictionary in sync */
+		auto peek = decodering.peek_buffer ();
+		ASSERT_TRUE (peek.has_value ());
+		ASSERT_TRUE (*peek == expected);
+
+		if ((pos % 3) == 1) {
+			ASSERT_TRUE (decodering.pop_buffer ());
+		}
+		else {
+			ASSERT_TRUE (decodering.pop_buffer (str));
+			ASSERT_TRUE (str == expected);
+		}
+	}
+	ASSERT_FALSE (decodering.pop_buffer (str));
+	ASSERT_TRUE (decodering.get_err_count () == 0);
+}
+
+template<class T, template<class> class Encode, template<class> class Decode>
+static void _chunks_test (const bool compression)
+{
+	const size_t datasize = 1024;
+	const size_t num = 64;
+
+	Encode<T> encodering (datasize, num + 1);
+	Decode<T> decodering (datasize, num + 1);
+
+	if (true == compression) {
+		encodering.set_compression (true);
+		decodering.set_compression (true);
+	}
+
+	CHUNKLIST lst;
+	for (size_t pos = 0; pos < 200; ++pos) {
+		Chunk &chunk = lst.emplace_back (static_cast<HWID> (pos), "ABCD", Chunk::Priority::pMANDATORY);
+		chunk.set_payload (std::string ((pos * 7) % 300, static_cast<char> ('a' + (pos % 26))));
+		if ((pos % 3) == 0) {
+			chunk.meta.add_uint32 ("CNT", static_cast<uint32_t> (pos));
+		}
+	}
+
+	std::vector<std::string> expected;
+	for (const auto &chunk : lst) {
+		expected.push_back (chunk.to_bin ());
+	}
+
+	/* Chunk that does not fit into a packet must stay in container */
+	CHUNKLIST large;
+	large.emplace_back (1, "ABCD", Chunk::Priority::pMANDATORY).set_payload (std::string (datasize, 'x'));
+	ASSERT_THROW (encodering.push_chunks (large), CommonException);
+	ASSERT_TRUE (large.size () == 1);
+	ASSERT_TRUE (encodering.empty ());
+
+	size_t packets {0};
+	while (lst.empty () == false) {
+		const size_t before = lst.size ();
+		const size_t cnt = encodering.push_chunks (lst);
+		ASSERT_TRUE (cnt > 0);
+		ASSERT_TRUE (lst.size () + cnt == before);
+		++packets;
+	}
+
+	/* Chunks must be packed, not pushed one by one */
+	ASSERT_TRUE (packets < (expected.size () / 4));
+
+	const Chunk single (7, "EFGH", Chunk::Priority::pCRITICAL);
+	ASSERT_NO_THROW (encodering.push_chunk (single));
+	expected.push_back (single.to_bin ());
+
+	std::string tempbuffer (encodering.get_stored_bytes () + datasize, '\0');
+	while (true) {
+		const size_t available = encodering.fill_front_buffer (tempbuffer.data (), tempbuffer.size ());
+		if (0 == available) {
+			break;
+		}
+		ASSERT_NO_THROW (decodering.push_buffer (tempbuffer.data (), available));
+		ASSERT_NO_THROW (encodering.move_front_buffer (available));
+	}
+
+	ASSERT_TRUE (decodering.get_err_count_reset () == 0);
+
+	ChunkTool tool;
+	CHUNKLIST decoded;
+	std::string str;
+	while (decodering.pop_buffer (str) == true) {
+		ASSERT_TRUE (str.size () <= datasize);
+		ASSERT_NO_THROW (tool.from_bin (str, decoded));
+	}
+
+	ASSERT_TRUE (decoded.size () == expected.size ());
+	size_t pos {0};
+	for (const auto &chunk : decoded) {
+		ASSERT_TRUE (chunk.to_bin () == expected[pos]);
+		++pos;
+	}
+}
+
 TEST (EncDecSPSC, simplenewline_push_pop_prealloc)
 {
 	_simplenewlinespsc_test<SPSCDataPreAlloc> ();
@@ -675,3 +935,43 @@ TEST (EncDecSPSC, seqpacket_different_sizes)
 {
 	_seqpacket_sizes_test<SPSCDataDynAlloc> ();
 }
+
+TEST (EncDecSPSC, varpacket_push_pop_prealloc)
+{
+	_varpacketspsc_test<SPSCDataPreAlloc> (false);
+	_varpacketspsc_test<SPSCDataPreAlloc> (true);
+}
+
+TEST (EncDecSPSC, varpacket_push_pop)
+{
+	_varpacketspsc_test<SPSCDataDynAlloc> (false);
+	_varpacketspsc_test<SPSCDataDynAlloc> (true);
+}
+
+TEST (EncDecSPSC, varpacket_different_sizes)
+{
+	_varpacket_sizes_test<SPSCDataDynAlloc> (false);
+	_varpacket_sizes_test<SPSCDataDynAlloc> (true);
+}
+
+TEST (EncDecSPSC, compression)
+{
+	_compression_test<SPSCDataPreAlloc> (false);
+	_compression_test<SPSCDataPreAlloc> (true);
+	_compression_test<SPSCDataDynAlloc> (false);
+	_compression_test<SPSCDataDynAlloc> (true);
+}
+
+TEST (EncDecSPSC, packet_chunks)
+{
+	_chunks_test<SPSCDataPreAlloc, PacketEncodeSPSC, PacketDecodeSPSC> (false);
+	_chunks_test<SPSCDataDynAlloc, PacketEncodeSPSC, PacketDecodeSPSC> (false);
+	_chunks_test<SPSCDataDynAlloc, PacketEncodeSPSC, PacketDecodeSPSC> (true);
+}
+
+TEST (EncDecSPSC, seqpacket_chunks)
+{
+	_chunks_test<SPSCDataPreAlloc, SeqPacketEncodeSPSC, SeqPacketDecodeSPSC> (false);
+	_chunks_test<SPSCDataDynAlloc, SeqPacketEncodeSPSC, SeqPacketDecodeSPSC> (false);
+	_chunks_test<SPSCDataDynAlloc, SeqPacketEncodeSPSC, SeqPacketDecodeSPSC> (true);
+}
@@ -0,0 +1,66 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#include <gtest/gtest.h>
+
+using namespace shaga;
+
+TEST (HWIDTable, lookup)
+{
+	HWIDTable<int> table;
+
+	EXPECT_TRUE (table.insert (HWIDMASK (0x12345678), 1));
+	EXPECT_TRUE (table.insert (HWIDMASK (0x12340000, 0xFFFF0000), 2));
+	EXPECT_TRUE (table.insert (HWIDMASK (0x12000000, 0xFF000000), 3));
+	EXPECT_TRUE (table.insert (HWIDMASK (0x00000078, 0x000000FF), 4));
+	EXPECT_TRUE (table.insert (HWIDMASK (0, 0), 5));
+	EXPECT_FALSE (table.insert (HWIDMASK (0x1234FFFF, 0xFFFF0000), 6));
+	EXPECT_TRUE (table.size () == 5);
+
+	const std::vector<std::pair<HWID, int>> expected {{0x12345678, 1}, {0x12345600, 2}, {0x12005678, 3}, {0x99999978, 4}, {0x99999999, 5}};
+	for (const auto &[hwid, value] : expected) {
+		const int *const found = table.find_longest (hwid);
+		ASSERT_TRUE (found != nullptr);
+		EXPECT_TRUE (*found == value);
+	}
+
+	/* All matches from the longest mask, 8-bit masks are ordered by value with the higher one first */
+	std::vector<int> all;
+	for (const int *v : table.find_all (0x12345678)) {
+		all.push_back (*v);
+	}
+	EXPECT_TRUE (all == std::vector<int> ({1, 2, 3, 4, 5}));
+
+	/* Same result as linear check over all routes */
+	const HWID_VECTOR hwids {0x12345678, 0x12345600, 0x12005678, 0x99999978, 0x99999999};
+	std::vector<const int *> out;
+	table.find_longest (hwids, out);
+	ASSERT_TRUE (out.size () == hwids.size ());
+	for (size_t pos = 0; pos < hwids.size (); ++pos) {
+		EXPECT_TRUE (out[pos] == table.find_longest (hwids[pos]));
+	}
+
+	EXPECT_TRUE (table.remove (HWIDMASK (0x12345678)));
+	EXPECT_FALSE (table.remove (HWIDMASK (0x12345678)));
+	const int *const longest = table.find_longest (0x12345678);
+	ASSERT_TRUE (longest != nullptr);
+	EXPECT_TRUE (*longest == 2);
+	EXPECT_TRUE (table.find (HWIDMASK (0x12345678)) == nullptr);
+
+	table.insert_or_assign (HWIDMASK (0x12340000, 0xFFFF0000), 7);
+	const int *const assigned = table.find (HWIDMASK (0x12340000, 0xFFFF0000));
+	ASSERT_TRUE (assigned != nullptr);
+	EXPECT_TRUE (*assigned == 7);
+	EXPECT_TRUE (table.size () == 4);
+
+	EXPECT_TRUE (table.remove (HWIDMASK (0, 0)));
+	EXPECT_TRUE (table.find_longest (0x99999999) == nullptr);
+
+	table.clear ();
+	EXPECT_TRUE (table.empty ());
+	EXPECT_TRUE (table.find_longest (0x12345678) == nullptr);
+}
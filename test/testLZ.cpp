@@ -0,0 +1,158 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#include <gtest/gtest.h>
+
+using namespace shaga;
+
+static std::string _lz_text (const size_t sze)
+{
+	static const std::string_view words[] = {"chunk "sv, "channel "sv, "hwid "sv, "payload "sv, "ring "sv, "tracert "sv, "meta "sv};
+	std::string out;
+	size_t seed = 7;
+
+	while (out.size () < sze) {
+		seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+		out.append (words[seed % (sizeof (words) / sizeof (words[0]))]);
+	}
+	out.resize (sze);
+	return out;
+}
+
+static std::string _lz_random (const size_t sze)
+{
+	std::string out (sze, '\0');
+	uint32_t seed = 0x12345678;
+
+	for (auto &c : out) {
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		c = static_cast<char> (seed & 0xff);
+	}
+	return out;
+}
+
+TEST (LZ, round_trip)
+{
+	for (const bool dict : {false, true}) {
+		LZ::Compressor comp (dict);
+		LZ::Decompressor decomp (dict);
+
+		for (const size_t sze : {0, 1, 15, 16, 17, 100, 1000, 65'535, 65'536, 200'000}) {
+			const std::string plain = _lz_text (sze);
+			const std::string frame = comp.compress (plain);
+			EXPECT_TRUE (frame.size () <= (plain.size () + 1));
+			if (sze >= 100) {
+				EXPECT_TRUE (frame.size () < plain.size ());
+			}
+			EXPECT_TRUE (decomp.decompress (frame) == plain);
+		}
+
+		/* Long runs use overlapping matches */
+		const std::string plain (10'000, 'x');
+		const std::string frame = comp.compress (plain);
+		EXPECT_TRUE (frame.size () < 100);
+		EXPECT_TRUE (decomp.decompress (frame) == plain);
+	}
+}
+
+TEST (LZ, dictionary)
+{
+	LZ::Compressor comp;
+	LZ::Decompressor decomp;
+
+	const std::string plain = _lz_random (1000);
+
+	const std::string first = comp.compress (plain);
+	EXPECT_TRUE (first.size () == (plain.size () + 1));
+	EXPECT_TRUE (first[0] == static_cast<char> (LZ::frame_stored));
+	EXPECT_TRUE (decomp.decompress (first) == plain);
+
+	/* Stored frames disable compression for one frame */
+	EXPECT_TRUE (decomp.decompress (comp.compress (plain)) == plain);
+
+	/* Same data again references previous frame */
+	const std::string second = comp.compress (plain);
+	EXPECT_TRUE (second[0] == static_cast<char> (LZ::frame_compressed));
+	EXPECT_TRUE (second.size () < 32);
+	EXPECT_TRUE (decomp.decompress (second) == plain);
+
+	/* Without dictionary, random data never compress */
+	LZ::Compressor comp_nodict (false);
+	LZ::Decompressor decomp_nodict (false);
+	for (size_t pos = 0; pos < 4; ++pos) {
+		const std::string frame = comp_nodict.compress (plain);
+		EXPECT_TRUE (frame[0] == static_cast<char> (LZ::frame_stored));
+		EXPECT_TRUE (decomp_nodict.decompress (frame) == plain);
+	}
+}
+
+TEST (LZ, rollback)
+{
+	LZ::Compressor comp;
+	LZ::Decompressor decomp;
+
+	const std::string a = _lz_text (5000);
+	std::string b (a);
+	std::transform (b.begin (), b.end (), b.begin (), [](const char c) -> char { return static_cast<char> (::toupper (c)); });
+
+	EXPECT_TRUE (decomp.decompress (comp.compress (a)) == a);
+
+	/* Frame compresses, so skipping is not triggered, but it is never delivered */
+	const std::string lost = comp.compress (b);
+	EXPECT_TRUE (static_cast<uint8_t> (lost[0]) == LZ::frame_compressed);
+	comp.rollback ();
+
+	/* If dictionary wasn't rolled back, this frame would reference data decompressor doesn't have */
+	const std::string frame = comp.compress (b + a);
+	EXPECT_TRUE (static_cast<uint8_t> (frame[0]) == LZ::frame_compressed);
+
+	std::string out;
+	ASSERT_NO_THROW (out = decomp.decompress (frame));
+	EXPECT_TRUE (out == (b + a));
+}
+
+TEST (LZ, skip_without_dictionary)
+{
+	LZ::Compressor comp (false);
+	LZ::Decompressor decomp (false);
+
+	const std::string a = _lz_text (5000);
+	const std::string b = _lz_random (5000);
+
+	std::string frame = comp.compress (a);
+	EXPECT_TRUE (static_cast<uint8_t> (frame[0]) == LZ::frame_compressed);
+
+	frame = comp.compress (b);
+	EXPECT_TRUE (static_cast<uint8_t> (frame[0]) == LZ::frame_stored);
+	EXPECT_TRUE (decomp.decompress (frame) == b);
+
+	/* Compression is skipped for the next frame, even if it would compress */
+	frame = comp.compress (a);
+	EXPECT_TRUE (static_cast<uint8_t> (frame[0]) == LZ::frame_stored);
+	EXPECT_TRUE (decomp.decompress (frame) == a);
+}
+
+TEST (LZ, malformed)
+{
+	LZ::Compressor comp;
+	LZ::Decompressor decomp;
+
+	const std::string plain = _lz_text (1000);
+	std::string frame = comp.compress (plain);
+
+	EXPECT_THROW (decomp.decompress (""sv), CommonException);
+	EXPECT_THROW (decomp.decompress ("\x05xyz"sv), CommonException);
+	EXPECT_THROW (decomp.decompress (std::string_view (frame).substr (0, frame.size () - 1)), CommonException);
+
+	/* Offset pointing before start of dictionary */
+	EXPECT_THROW (decomp.decompress ("\x01\x08\x00\xff\xff\x00"sv), CommonException);
+
+	/* Failed frames don't change dictionary */
+	EXPECT_TRUE (decomp.decompress (frame) == plain);
+}
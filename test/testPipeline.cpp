@@ -0,0 +1,196 @@
+/******************************************************************************
+Shaga library is released under the New BSD license (see LICENSE.md):
+
+Copyright (c) 2012-2026, SAGE team s.r.o., Samuel Kupka
+
+All rights reserved.
+*******************************************************************************/
+#include <gtest/gtest.h>
+
+using namespace shaga;
+
+#ifdef SHAGA_THREADING
+
+TEST (Pipeline, parse_and_route)
+{
+	const size_t num_batches = 200;
+	const size_t chunks_per_bin = 10;
+	const size_t bins_per_batch = 5;
+
+	/* ChunkTool::to_bin is not thread-safe, so encoder uses its own instance */
+	ChunkTool tool;
+	ChunkTool encode_tool;
+	std::atomic<uint64_t> routed {0};
+	std::atomic<uint64_t> hwid_sum {0};
+
+	Pipeline pipe;
+	auto &input = pipe.add_ring<std::string> (4);
+	auto &parsed = pipe.add_ring<Chunk> (4);
+
+	pipe.add_stage<std::string, Chunk> ("parse"sv, input, parsed, [&tool](PipelineBatch<std::string> &in, PipelineBatch<Chunk> &out) {
+		for (const auto &bin : in) {
+			if (bin.empty () == true) {
+				cThrow ("Empty buffer"sv);
+			}
+			CHUNKLIST lst = tool.from_bin<CHUNKLIST> (bin);
+			std::move (lst.begin (), lst.end (), std::back_inserter (out));
+		}
+	});
+
+	pipe.add_sink<Chunk> ("route"sv, parsed, [&](PipelineBatch<Chunk> &in) {
+		for (const auto &chunk : in) {
+			hwid_sum += chunk.get_source_hwid ();
+		}
+		routed += in.size ();
+	});
+
+	EXPECT_THROW (pipe.add_ring<int> (1), CommonException);
+
+	pipe.start ();
+	EXPECT_TRUE (pipe.is_running ());
+	EXPECT_THROW (pipe.start (), CommonException);
+	EXPECT_THROW (pipe.add_ring<int> (4), CommonException);
+
+	uint64_t expected_sum {0};
+	for (size_t batch = 0; batch < num_batches; ++batch) {
+		PipelineBatch<std::string> bins;
+
+		for (size_t b = 0; b < bins_per_batch; ++b) {
+			CHUNKLIST lst;
+			for (size_t i = 0; i < chunks_per_bin; ++i) {
+				lst.emplace_back (static_cast<HWID> (i + 1), "ABCD", Chunk::Priority::pMANDATORY);
+				expected_sum += i + 1;
+			}
+			bins.push_back (encode_tool.to_bin (lst));
+		}
+
+		while (input.push_back (std::move (bins)) == false) {
+			std::this_thread::yield ();
+		}
+	}
+
+	/* One bad batch is counted as error */
+	while (input.push_back (PipelineBatch<std::string> (1)) == false) {
+		std::this_thread::yield ();
+	}
+
+	const size_t total = num_batches * bins_per_batch * chunks_per_bin;
+	for (size_t i = 0; i < 10000 && (routed.load () < total || pipe.get_counters ()[0].second.errors == 0); ++i) {
+		std::this_thread::sleep_for (std::chrono::milliseconds (1));
+	}
+
+	pipe.stop ();
+	EXPECT_FALSE (pipe.is_running ());
+
+	EXPECT_TRUE (routed.load () == total);
+	EXPECT_TRUE (hwid_sum.load () == expected_sum);
+
+	const auto counters = pipe.get_counters ();
+	ASSERT_TRUE (counters.size () == 2);
+
+	EXPECT_TRUE (counters[0].first == "parse");
+	EXPECT_TRUE (counters[0].second.batches_in == (num_batches + 1));
+	EXPECT_TRUE (counters[0].second.items_in == ((num_batches * bins_per_batch) + 1));
+	EXPECT_TRUE (counters[0].second.batches_out == num_batches);
+	EXPECT_TRUE (counters[0].second.items_out == total);
+	EXPECT_TRUE (counters[0].second.errors == 1);
+
+	EXPECT_TRUE (counters[1].first == "route");
+	EXPECT_TRUE (counters[1].second.batches_in == num_batches);
+	EXPECT_TRUE (counters[1].second.items_in == total);
+	EXPECT_TRUE (counters[1].second.errors == 0);
+
+	pipe.reset_counters ();
+	EXPECT_TRUE (pipe.get_counters ()[0].second.batches_in == 0);
+}
+
+TEST (Pipeline, pinned)
+{
+	Pipeline pipe;
+	auto &input = pipe.add_ring<int> (16);
+	std::atomic<int> sum {0};
+
+	pipe.add_sink<int> ("sink"sv, input, [&sum](PipelineBatch<int> &in) {
+		for (const int val : in) {
+			sum += val;
+		}
+	}, 0);
+
+	EXPECT_THROW (pipe.add_sink<int> ("bad"sv, input, [](PipelineBatch<int> &) {}, -2), CommonException);
+
+	pipe.start ();
+	for (int i = 1; i <= 10; ++i) {
+		while (input.push_back (PipelineBatch<int> {i, i}) == false) {
+			std::this_thread::yield ();
+		}
+	}
+
+	for (size_t i = 0; i < 10000 && sum.load () < 110; ++i) {
+		std::this_thread::sleep_for (std::chrono::milliseconds (1));
+	}
+	pipe.stop ();
+
+	EXPECT_TRUE (sum.load () == 110);
+}
+
+TEST (Pipeline, decode_source)
+{
+	const size_t num_packets = 500;
+
+	SeqPacketDecodeSPSC<SPSCDataDynAlloc> decoder (256, 64);
+	std::atomic<uint64_t> received {0};
+	std::atomic<uint64_t> bytes {0};
+
+	Pipeline pipe;
+	auto &input = pipe.add_ring<std::string> (4);
+
+	EXPECT_THROW (pipe.add_source ("bad"sv, decoder, input, nullptr, 0), CommonException);
+
+	pipe.add_source ("source"sv, decoder, input, nullptr, 8);
+	pipe.add_sink<std::string> ("sink"sv, input, [&](PipelineBatch<std::string> &in) {
+		EXPECT_TRUE (in.size () <= 8);
+		for (const auto &buf : in) {
+			bytes += buf.size ();
+		}
+		received += in.size ();
+	});
+
+	pipe.start ();
+
+	/* Reader thread of the application */
+	uint64_t expected_bytes {0};
+	for (size_t i = 0; i < num_packets; ++i) {
+		const std::string data (1 + (i % 200), static_cast<char> ('a' + (i % 26)));
+		expected_bytes += data.size ();
+
+		std::string packet;
+		BIN::from_uint24 (static_cast<uint32_t> (data.size ()), packet);
+		packet.append (data);
+
+		while (true) {
+			try {
+				decoder.push_buffer (packet);
+				break;
+			}
+			catch (const CommonException &) {
+				/* Ring is full */
+				std::this_thread::yield ();
+			}
+		}
+	}
+
+	for (size_t i = 0; i < 10000 && received.load () < num_packets; ++i) {
+		std::this_thread::sleep_for (std::chrono::milliseconds (1));
+	}
+	pipe.stop ();
+
+	EXPECT_TRUE (received.load () == num_packets);
+	EXPECT_TRUE (bytes.load () == expected_bytes);
+
+	const auto counters = pipe.get_counters ();
+	EXPECT_TRUE (counters[0].second.items_in == num_packets);
+	EXPECT_TRUE (counters[0].second.items_out == num_packets);
+	EXPECT_TRUE (counters[0].second.errors == 0);
+}
+
+#endif // SHAGA_THREADING
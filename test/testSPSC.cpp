@@ -167,3 +167,67 @@ TEST (PreAllocSPSC, non_trivial_container)
 		EXPECT_THROW (ring.pop_front (), CommonException);
 	}
 }
+
+TEST (PreAllocSPSC, reserve_commit)
+{
+	const uint_fast32_t sze = 32;
+	const int loops = 128;
+	PreAllocSPSC<int> ring (sze);
+
+	int val_write {0};
+	int val_read {0};
+
+	for (int i = 0; i < loops; ++i) {
+		/* Write in batches of different sizes, each batch can be split in two by wrap around */
+		const uint_fast32_t batch = (i % 7) + 1;
+		uint_fast32_t written {0};
+
+		while (written < batch) {
+			auto span = ring.reserve (batch - written);
+			if (span.empty () == true) {
+				break;
+			}
+			for (int &val : span) {
+				val = val_write++;
+			}
+			EXPECT_THROW (ring.commit (sze), CommonException);
+			ring.commit (span.size ());
+			written += span.size ();
+		}
+		EXPECT_TRUE (written == batch);
+
+		/* Read back only part of data, so positions keep moving */
+		auto span = ring.front_span ((i % 5) + 1);
+		ASSERT_FALSE (span.empty ());
+		for (uint_fast32_t pos = 0; pos < span.size (); ++pos) {
+			EXPECT_TRUE (span[pos] == val_read++);
+		}
+		EXPECT_THROW (ring.release (sze), CommonException);
+		ring.release (span.size ());
+
+		if ((i % 3) == 2) {
+			for (auto s = ring.front_span (); s.empty () == false; s = ring.front_span ()) {
+				for (const int val : s) {
+					EXPECT_TRUE (val == val_read++);
+				}
+				ring.release (s.size ());
+			}
+			EXPECT_TRUE (ring.empty ());
+		}
+	}
+
+	/* Fill completely, only sze - 1 slots can be used */
+	ring.clear ();
+	EXPECT_TRUE (ring.empty ());
+	uint_fast32_t total {0};
+	for (auto span = ring.reserve (sze); span.empty () == false; span = ring.reserve (sze)) {
+		ring.commit (span.size ());
+		total += span.size ();
+	}
+	EXPECT_TRUE (total == (sze - 1));
+	EXPECT_TRUE (ring.full ());
+
+	ring.clear ();
+	EXPECT_TRUE (ring.empty ());
+	EXPECT_TRUE (ring.front_span ().empty ());
+}